@@ -0,0 +1,148 @@
+//This file is part of XpanderSinglePatchViewer
+
+//XpanderSinglePatchViewer is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//XpanderSinglePatchViewer is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with XpanderSinglePatchViewer.
+//If not, see <http://www.gnu.org/licenses/>.
+
+//============================================================================
+// Capture test: a file holding cut single patch messages around complete
+// ones is captured as a stream device. Only the complete messages must be
+// archived, and the cut ones counted as truncated. The files are written to
+// and removed from the current directory.
+// Usage: CaptureTest
+//============================================================================
+
+// windows stuff
+#include "stdafx.h"
+#include <windows.h>
+
+//stdlib
+#include <stdlib.h>
+#include <string.h>
+
+#include "XpanderCapture.h"
+#include "XpanderSinglePatch.h"
+
+static const char* INPUT_FILE_NAME = "CaptureTest_input.syx";
+// complete messages of the input
+static const int GOOD_PATCH_COUNT = 2;
+// cut messages of the input: status byte in the data, wrong EOX, end of file
+static const int CUT_PATCH_COUNT = 3;
+
+//----------------------------------------------------------------------------
+/*! Build a complete single patch message named after its program number
+*/
+static void BuildMessage(unsigned char programNumber, unsigned char* pMessage) {
+	SinglePatch patch;
+	memset(&patch, 0, sizeof(SinglePatch));
+	char szName[PATCHNAME_LENGTH + 1];
+	sprintf_s(szName, sizeof(szName), "GOOD %02d ", programNumber);
+	for (int i = 0; i < PATCHNAME_LENGTH; i++) {
+		patch.name.character[i] = (wchar_t)szName[i];
+	}
+	EncodeSinglePatchData(&patch, programNumber, pMessage);
+}
+
+//----------------------------------------------------------------------------
+/*! Read a whole file
+@return the content, NULL if the file can not be read
+*/
+static unsigned char* ReadWholeFile(const char* pszFileName, size_t* pSize) {
+	FILE* pFile = NULL;
+	fopen_s(&pFile, pszFileName, "rb");
+	if (pFile == NULL) {
+		return NULL;
+	}
+	fseek(pFile, 0, SEEK_END);
+	long size = ftell(pFile);
+	fseek(pFile, 0, SEEK_SET);
+	unsigned char* pData = (unsigned char*)malloc(size + 1);
+	if (pData != NULL) {
+		*pSize = fread(pData, 1, size, pFile);
+	}
+	fclose(pFile);
+	return pData;
+}
+
+//----------------------------------------------------------------------------
+int _tmain(int argc, _TCHAR* argv[])
+{
+	unsigned char good[GOOD_PATCH_COUNT][SINGLE_PATCH_SYSEX_LENGTH];
+	unsigned char cut[SINGLE_PATCH_SYSEX_LENGTH];
+	for (int i = 0; i < GOOD_PATCH_COUNT; i++) {
+		BuildMessage((unsigned char)(i + 1), good[i]);
+	}
+	BuildMessage(99, cut);
+
+	// cut, good, wrong EOX, good, cut by the end of the file
+	FILE* pInput = NULL;
+	fopen_s(&pInput, INPUT_FILE_NAME, "wb");
+	if (pInput == NULL) {
+		fprintf(stderr, "Can't write %s!\n", INPUT_FILE_NAME);
+		return 1;
+	}
+	fwrite(cut, 1, SINGLE_PATCH_SYSEX_LENGTH / 2, pInput);
+	fwrite(good[0], 1, SINGLE_PATCH_SYSEX_LENGTH, pInput);
+	fwrite(cut, 1, SINGLE_PATCH_SYSEX_LENGTH - 1, pInput);
+	fputc(0x00, pInput);
+	fwrite(good[1], 1, SINGLE_PATCH_SYSEX_LENGTH, pInput);
+	fwrite(cut, 1, SINGLE_PATCH_SYSEX_LENGTH / 2, pInput);
+	fclose(pInput);
+
+	Capture capture;
+	InitCapture(&capture, ".", CAPTURE_DEFAULT_IDLE_TIMEOUT);
+	int failureCount = 0;
+	if (!AddCaptureDevice(&capture, INPUT_FILE_NAME) || !RunCapture(&capture)) {
+		fprintf(stderr, "Can't capture %s!\n", INPUT_FILE_NAME);
+		failureCount++;
+	}
+	else {
+		const CaptureDevice* pDevice = capture.pDevices[0];
+		if (pDevice->patchCount != GOOD_PATCH_COUNT || pDevice->truncatedCount != CUT_PATCH_COUNT) {
+			fprintf(stderr, "%llu patches and %llu truncated, %d and %d expected!\n", pDevice->patchCount,
+				pDevice->truncatedCount, GOOD_PATCH_COUNT, CUT_PATCH_COUNT);
+			failureCount++;
+		}
+	}
+
+	// the archive is only complete once closed
+	char szArchiveFileName[MAX_PATH];
+	char szIndexFileName[MAX_PATH];
+	strcpy_s(szArchiveFileName, MAX_PATH, (capture.deviceCount > 0) ? capture.pDevices[0]->szArchiveFileName : "");
+	strcpy_s(szIndexFileName, MAX_PATH, szArchiveFileName);
+	size_t nameLength = strlen(szIndexFileName);
+	if (nameLength > 3) {
+		strcpy_s(szIndexFileName + nameLength - 3, 4, "txt");
+	}
+	ReleaseCapture(&capture);
+
+	size_t archiveSize = 0;
+	unsigned char* pArchive = ReadWholeFile(szArchiveFileName, &archiveSize);
+	if (pArchive == NULL) {
+		fprintf(stderr, "Can't read the archive %s!\n", szArchiveFileName);
+		failureCount++;
+	}
+	else if (archiveSize != sizeof(good) || memcmp(pArchive, good, sizeof(good)) != 0) {
+		fprintf(stderr, "The archive does not hold exactly the %d complete messages!\n", GOOD_PATCH_COUNT);
+		failureCount++;
+	}
+	free(pArchive);
+
+	remove(INPUT_FILE_NAME);
+	remove(szArchiveFileName);
+	remove(szIndexFileName);
+	if (failureCount == 0) {
+		fprintf(stdout, "%d complete messages archived, %d cut messages skipped\n", GOOD_PATCH_COUNT, CUT_PATCH_COUNT);
+	}
+	return (failureCount == 0) ? 0 : 1;
+}
@@ -0,0 +1,44 @@
+//This file is part of XpanderSinglePatchViewer
+
+//XpanderSinglePatchViewer is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//XpanderSinglePatchViewer is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with XpanderSinglePatchViewer.
+//If not, see <http://www.gnu.org/licenses/>.
+
+//============================================================================
+// Counting allocator of the allocation test, force included (/FI) in every
+// source of the project: the heap calls of the code under test go through
+// counters, in any configuration and with any CRT.
+// operator new and delete are replaced in DecodeContextTest.cpp.
+//============================================================================
+
+#ifndef _COUNTINGALLOCATOR__
+#define _COUNTINGALLOCATOR__
+
+// declared before the macros below
+#include <stdlib.h>
+
+// heap calls seen so far
+extern volatile long g_allocationCount;
+extern volatile long g_freeCount;
+
+void* CountingMalloc(size_t size);
+void* CountingCalloc(size_t count, size_t size);
+void* CountingRealloc(void* pMemory, size_t size);
+void CountingFree(void* pMemory);
+
+#define malloc(size) CountingMalloc(size)
+#define calloc(count, size) CountingCalloc(count, size)
+#define realloc(pMemory, size) CountingRealloc(pMemory, size)
+#define free(pMemory) CountingFree(pMemory)
+
+#endif // _COUNTINGALLOCATOR__
@@ -0,0 +1,208 @@
+//This file is part of XpanderSinglePatchViewer
+
+//XpanderSinglePatchViewer is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//XpanderSinglePatchViewer is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with XpanderSinglePatchViewer.
+//If not, see <http://www.gnu.org/licenses/>.
+
+//============================================================================
+// Allocation test of the decode context: after a warm-up batch, decoding the
+// same buffer again and again with DecodeContextReset() in between must not
+// allocate or free anything. malloc, calloc, realloc and free are counted by
+// CountingAllocator.h, operator new and delete are replaced below.
+// Usage: DecodeContextTest [patch count] [batch count]
+//============================================================================
+
+// windows stuff
+#include "stdafx.h"
+
+//stdlib
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+
+#include "CountingAllocator.h"
+#include "XpanderDecodeContext.h"
+#include "XpanderSinglePatch.h"
+
+// the counters call the real functions, the test itself is not counted
+#undef malloc
+#undef calloc
+#undef realloc
+#undef free
+
+static const int DEFAULT_PATCH_COUNT = 1000;
+static const int DEFAULT_BATCH_COUNT = 100;
+// names and dumps of a whole batch
+static const size_t TEXT_CAPACITY_PER_PATCH = 16 * 1024;
+
+volatile long g_allocationCount = 0;
+volatile long g_freeCount = 0;
+
+//----------------------------------------------------------------------------
+void* CountingMalloc(size_t size) {
+	g_allocationCount++;
+	return malloc(size);
+}
+
+//----------------------------------------------------------------------------
+void* CountingCalloc(size_t count, size_t size) {
+	g_allocationCount++;
+	return calloc(count, size);
+}
+
+//----------------------------------------------------------------------------
+void* CountingRealloc(void* pMemory, size_t size) {
+	g_allocationCount++;
+	return realloc(pMemory, size);
+}
+
+//----------------------------------------------------------------------------
+void CountingFree(void* pMemory) {
+	if (pMemory != NULL) {
+		g_freeCount++;
+	}
+	free(pMemory);
+}
+
+//----------------------------------------------------------------------------
+void* operator new(size_t size) {
+	void* pMemory = CountingMalloc((size > 0) ? size : 1);
+	if (pMemory == NULL) {
+		throw std::bad_alloc();
+	}
+	return pMemory;
+}
+
+//----------------------------------------------------------------------------
+void* operator new[](size_t size) {
+	return operator new(size);
+}
+
+//----------------------------------------------------------------------------
+void operator delete(void* pMemory) throw() {
+	CountingFree(pMemory);
+}
+
+//----------------------------------------------------------------------------
+void operator delete[](void* pMemory) throw() {
+	CountingFree(pMemory);
+}
+
+//----------------------------------------------------------------------------
+/*! Build a buffer of patchCount single patch messages, with a few bytes of
+noise in between to exercise the intro search
+@return the buffer, NULL if not enough memory
+*/
+static unsigned char* BuildSysExBuffer(int patchCount, size_t* pSize) {
+	static const unsigned char INTRO[PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH - 1] = { 0xF0, 0x10, 0x02, 0x01, 0x00 };
+	static const unsigned char NOISE[] = { 0x00, 0xF0, 0x7E };
+	static const char NAME[PATCHNAME_LENGTH + 1] = "ARENA   ";
+
+	size_t messageSize = SINGLE_PATCH_SYSEX_LENGTH + sizeof(NOISE);
+	unsigned char* pData = (unsigned char*)malloc(patchCount * messageSize);
+	if (pData == NULL) {
+		return NULL;
+	}
+	unsigned char* pMessage = pData;
+	for (int i = 0; i < patchCount; i++) {
+		memcpy(pMessage, INTRO, sizeof(INTRO));
+		pMessage[PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH - 1] = (unsigned char)(i % 100);
+		// every value is sent as 2 bytes: low 7 bits first, then the 8th bit
+		unsigned char* pValues = pMessage + PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH;
+		memset(pValues, 0, SINGLE_PATCH_DATA_LENGTH);
+		for (int j = 0; j < PATCHNAME_LENGTH; j++) {
+			pValues[(OBWORDS_DATA_LENGTH + j) * 2] = (unsigned char)NAME[j];
+		}
+		pMessage[SINGLE_PATCH_SYSEX_LENGTH - 1] = SYSEX_EOX;
+		memcpy(pMessage + SINGLE_PATCH_SYSEX_LENGTH, NOISE, sizeof(NOISE));
+		pMessage += messageSize;
+	}
+	*pSize = patchCount * messageSize;
+	return pData;
+}
+
+//----------------------------------------------------------------------------
+/*! Decode the whole buffer, resetting the context after each batch
+@return number of decoded patches, -1 if the context could not hold a patch
+*/
+static int DecodeAll(DecodeContext* pContext, const unsigned char* pData, size_t size, int flags) {
+	int patchCount = 0;
+	size_t offset = 0;
+	while (offset < size) {
+		DecodeContextReset(pContext);
+		offset = DecodeBatch(pContext, pData, size, offset, flags);
+		if (pContext->patchCount == 0 && offset < size) {
+			return -1;
+		}
+		patchCount += pContext->patchCount;
+	}
+	return patchCount;
+}
+
+//----------------------------------------------------------------------------
+int _tmain(int argc, _TCHAR* argv[])
+{
+	int patchCount = (argc > 1) ? _ttoi(argv[1]) : DEFAULT_PATCH_COUNT;
+	int batchCount = (argc > 2) ? _ttoi(argv[2]) : DEFAULT_BATCH_COUNT;
+	if (patchCount <= 0 || batchCount <= 0) {
+		fprintf(stderr, "Please specify a patch count and a batch count!\n");
+		return 1;
+	}
+	size_t size = 0;
+	unsigned char* pData = BuildSysExBuffer(patchCount, &size);
+	DecodeContext context;
+	// a context smaller than the buffer, so that several batches are needed
+	int maxPatches = (patchCount + 2) / 3;
+	long initAllocationCount = g_allocationCount;
+	if (pData == NULL || !DecodeContextInit(&context, maxPatches, maxPatches * TEXT_CAPACITY_PER_PATCH)) {
+		fprintf(stderr, "Not enough memory!\n");
+		return 1;
+	}
+	// the arena block: proves that the code under test is counted
+	if (g_allocationCount != initAllocationCount + 1) {
+		fprintf(stderr, "DecodeContextInit() allocations are not counted, check CountingAllocator.h is force included!\n");
+		return 1;
+	}
+
+	int failureCount = 0;
+	static const int FLAGS[] = { DECODE_FLAG_NONE, DECODE_FLAG_DUMP };
+	for (int i = 0; i < sizeof(FLAGS) / sizeof(FLAGS[0]); i++) {
+		// warm-up: anything lazily allocated happens here
+		int decodedCount = DecodeAll(&context, pData, size, FLAGS[i]);
+
+		long allocationCount = g_allocationCount;
+		long freeCount = g_freeCount;
+		for (int j = 0; j < batchCount && decodedCount == patchCount; j++) {
+			decodedCount = DecodeAll(&context, pData, size, FLAGS[i]);
+		}
+		allocationCount = g_allocationCount - allocationCount;
+		freeCount = g_freeCount - freeCount;
+
+		if (decodedCount != patchCount) {
+			fprintf(stderr, "flags %d: only %d of %d patches decoded!\n", FLAGS[i], decodedCount, patchCount);
+			failureCount++;
+		}
+		else if (allocationCount != 0 || freeCount != 0) {
+			fprintf(stderr, "flags %d: %ld allocations and %ld frees for %d patches!\n", FLAGS[i],
+				allocationCount, freeCount, patchCount * batchCount);
+			failureCount++;
+		}
+		else {
+			fprintf(stdout, "flags %d: %d patches, no allocation\n", FLAGS[i], patchCount * batchCount);
+		}
+	}
+
+	DecodeContextRelease(&context);
+	free(pData);
+	return (failureCount == 0) ? 0 : 1;
+}
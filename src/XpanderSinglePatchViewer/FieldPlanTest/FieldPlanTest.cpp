@@ -0,0 +1,166 @@
+//This file is part of XpanderSinglePatchViewer
+
+//XpanderSinglePatchViewer is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//XpanderSinglePatchViewer is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with XpanderSinglePatchViewer.
+//If not, see <http://www.gnu.org/licenses/>.
+
+//============================================================================
+// Field plan test: patterns compiled by CompileFieldPlan() must select the
+// expected fields ('*' never crosses a '.', a match also selects the sub-
+// fields, unknown names are rejected), and a plan selecting everything must
+// repack exactly like RepackSinglePatchData().
+// Usage: FieldPlanTest
+//============================================================================
+
+// windows stuff
+#include "stdafx.h"
+
+//stdlib
+#include <stdlib.h>
+#include <string.h>
+
+#include "XpanderFieldPlan.h"
+#include "XpanderSinglePatch.h"
+
+// a pattern list and what it must select
+typedef struct _FieldPlanCase {
+	const char* pszFields;
+	bool bCompiled;			// false if a pattern matches no field
+	int fieldCount;
+	bool bName;
+	int rangeCount;
+	const char* pszUnknown;	// pattern reported when not compiled
+} FieldPlanCase;
+
+static const FieldPlanCase CASES[] = {
+	{ "*",					true,	OBWORDS_DATA_LENGTH,	true,	1,	"" },
+	{ "*.wave",				true,	7,		false,	7,	"" },	// 2 VCOs, 5 LFOs
+	{ "vcf.*",				true,	6,		false,	1,	"" },
+	{ "vcf",				true,	6,		false,	1,	"" },
+	{ "mod[3]",				true,	3,		false,	1,	"" },	// source, amount, destination
+	{ "mod",				true,	60,		false,	1,	"" },
+	{ "mod[*]",				true,	60,		false,	1,	"" },
+	{ "mod[*].*",			true,	60,		false,	1,	"" },
+	{ "mod[*].dest",		true,	20,		false,	20,	"" },
+	{ "vco[*].wave,name",	true,	2,		true,	2,	"" },
+	{ "vco[0],vco[1]",		true,	12,		false,	1,	"" },	// consecutive fields in one range
+	{ "name",				true,	0,		true,	0,	"" },
+	{ "*freq",				false,	0,		false,	0,	"*freq" },	// '*' stops at the '.'
+	{ "fm_lag.fm",			false,	0,		false,	0,	"fm_lag.fm" },	// only a prefix of fm_amp
+	{ "vcf.res,bogus",		false,	0,		false,	0,	"bogus" },
+	{ "vco1",				false,	0,		false,	0,	"vco1" }
+};
+static const int CASES_COUNT = sizeof(CASES) / sizeof(CASES[0]);
+
+// a field selected by no case above
+static const char* UNSELECTED_FIELDS = "lfo[0].speed";
+
+//----------------------------------------------------------------------------
+/*! Check a case
+@return false if the plan is not the expected one
+*/
+static bool CheckCase(const FieldPlanCase* pCase) {
+	FieldPlan plan;
+	char szUnknown[64] = "";
+	bool bCompiled = CompileFieldPlan(pCase->pszFields, &plan, szUnknown, sizeof(szUnknown));
+	if (bCompiled != pCase->bCompiled) {
+		fprintf(stderr, "\"%s\": %s!\n", pCase->pszFields, bCompiled ? "compiled" : "not compiled");
+		return false;
+	}
+	if (!bCompiled) {
+		if (strcmp(szUnknown, pCase->pszUnknown) != 0) {
+			fprintf(stderr, "\"%s\": unknown \"%s\", \"%s\" expected!\n", pCase->pszFields, szUnknown, pCase->pszUnknown);
+			return false;
+		}
+		return true;
+	}
+	if (plan.fieldCount != pCase->fieldCount || plan.bName != pCase->bName || plan.rangeCount != pCase->rangeCount) {
+		fprintf(stderr, "\"%s\": %d fields, name %d, %d ranges, expected %d, %d, %d!\n", pCase->pszFields,
+			plan.fieldCount, plan.bName, plan.rangeCount, pCase->fieldCount, pCase->bName, pCase->rangeCount);
+		return false;
+	}
+	return true;
+}
+
+//----------------------------------------------------------------------------
+/*! Repack a message with a plan, over a patch filled with a marker value
+*/
+static void RepackWithPlan(const char* pszFields, const unsigned char* pMessage, SinglePatch* pPatch) {
+	FieldPlan plan;
+	CompileFieldPlan(pszFields, &plan, NULL, 0);
+	memset(pPatch, 0xA5, sizeof(SinglePatch));
+	RepackPlannedFields(&plan, pMessage + PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH, pPatch);
+}
+
+//----------------------------------------------------------------------------
+/*! A plan selecting everything repacks like RepackSinglePatchData(), and
+a partial plan leaves the other fields untouched
+@return false if not
+*/
+static bool CheckRepacking() {
+	// every 8 bits value, and a name
+	SinglePatch patch;
+	memset(&patch, 0, sizeof(SinglePatch));
+	unsigned char* pBytes = (unsigned char*)&patch;
+	for (int i = 0; i < OBWORDS_DATA_LENGTH; i++) {
+		pBytes[i] = (unsigned char)(i * 37 + 11);
+	}
+	static const char NAME[PATCHNAME_LENGTH + 1] = "PLANTEST";
+	for (int i = 0; i < PATCHNAME_LENGTH; i++) {
+		patch.name.character[i] = (wchar_t)NAME[i];
+	}
+	unsigned char message[SINGLE_PATCH_SYSEX_LENGTH];
+	EncodeSinglePatchData(&patch, 0, message);
+
+	SinglePatch expected;
+	RepackSinglePatchData(message + PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH, &expected);
+	SinglePatch planned;
+	RepackWithPlan("*", message, &planned);
+	bool bOk = (memcmp(&planned, &expected, OBWORDS_DATA_LENGTH) == 0);
+	for (int i = 0; i <= PATCHNAME_LENGTH; i++) {
+		bOk = bOk && (planned.name.character[i] == expected.name.character[i]);
+	}
+	if (!bOk) {
+		fprintf(stderr, "\"*\" does not repack like RepackSinglePatchData()!\n");
+		return false;
+	}
+
+	FieldPlan plan;
+	CompileFieldPlan(UNSELECTED_FIELDS, &plan, NULL, 0);
+	int unselected = plan.fields[0];
+	RepackWithPlan("vcf.*", message, &planned);
+	const unsigned char* pPlanned = (const unsigned char*)&planned;
+	if (pPlanned[offsetof(SinglePatch, vcf)] != pBytes[offsetof(SinglePatch, vcf)] || pPlanned[unselected] != 0xA5) {
+		fprintf(stderr, "\"vcf.*\" does not repack the VCF fields only!\n");
+		return false;
+	}
+	return true;
+}
+
+//----------------------------------------------------------------------------
+int _tmain(int argc, _TCHAR* argv[])
+{
+	int failureCount = 0;
+	for (int i = 0; i < CASES_COUNT; i++) {
+		if (!CheckCase(&CASES[i])) {
+			failureCount++;
+		}
+	}
+	if (!CheckRepacking()) {
+		failureCount++;
+	}
+	if (failureCount == 0) {
+		fprintf(stdout, "%d patterns and repacking checked\n", CASES_COUNT);
+	}
+	return (failureCount == 0) ? 0 : 1;
+}
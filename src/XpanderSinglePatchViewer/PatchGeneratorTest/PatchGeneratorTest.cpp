@@ -0,0 +1,170 @@
+//This file is part of XpanderSinglePatchViewer
+
+//XpanderSinglePatchViewer is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//XpanderSinglePatchViewer is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with XpanderSinglePatchViewer.
+//If not, see <http://www.gnu.org/licenses/>.
+
+//============================================================================
+// Patch generator test: large seeded batches are bred from random parents
+// with several mutation and crossover rates. Every generated patch must be
+// valid (IsPatchValid(), IsSinglePatchDumpable()), and both outputs must
+// round-trip: the packed SinglePatch encoded with EncodeSinglePatchData()
+// is a well formed single patch message, which RepackSinglePatchData()
+// turns back into the same patch.
+// Usage: PatchGeneratorTest [patch count per rate] [seed]
+//============================================================================
+
+// windows stuff
+#include "stdafx.h"
+
+//stdlib
+#include <stdlib.h>
+#include <string.h>
+
+#include "XpanderPatchGenerator.h"
+#include "XpanderSinglePatch.h"
+
+static const int DEFAULT_PATCH_COUNT = 250000;
+static const unsigned int DEFAULT_SEED = 2716;
+static const int PARENT_COUNT = 64;
+static const int BATCH_SIZE = 4096;
+
+// mutation and crossover rates tested
+typedef struct _GeneratorRates {
+	double mutationRate;
+	double crossoverRate;
+} GeneratorRates;
+static const GeneratorRates RATES[] = {
+	{ 0.05, 0.5 },	// defaults
+	{ 1.0, 0.0 },	// every field mutated
+	{ 0.0, 1.0 },	// crossover only
+	{ 1.0, 1.0 }
+};
+static const int RATES_COUNT = sizeof(RATES) / sizeof(RATES[0]);
+
+//----------------------------------------------------------------------------
+/*! Random parents: any byte value in any field, made valid by the generator
+*/
+static void BuildParents(SinglePatch* pParents, int count, unsigned int seed) {
+	PatchRng rng;
+	SeedPatchRng(&rng, seed);
+	unsigned int values[(OBWORDS_DATA_LENGTH + PATCH_RNG_LANES - 1) / PATCH_RNG_LANES * PATCH_RNG_LANES];
+	for (int i = 0; i < count; i++) {
+		memset(&pParents[i], 0, sizeof(SinglePatch));
+		FillPatchRng(&rng, values, sizeof(values) / sizeof(values[0]));
+		unsigned char* pByte = (unsigned char*)&pParents[i];
+		for (int j = 0; j < OBWORDS_DATA_LENGTH; j++) {
+			pByte[j] = (unsigned char)(values[j] >> 24);
+		}
+		char szName[PATCHNAME_LENGTH + 1];
+		sprintf_s(szName, sizeof(szName), "PARENT%02d", i % 100);
+		for (int j = 0; j < PATCHNAME_LENGTH; j++) {
+			pParents[i].name.character[j] = (wchar_t)szName[j];
+		}
+	}
+}
+
+//----------------------------------------------------------------------------
+/*! Check a generated patch and its encoded message
+@return NULL if the patch is correct, else what is wrong
+*/
+static const char* CheckGeneratedPatch(const PatchGenerator* pGenerator, const SinglePatch* pPatch, unsigned char programNumber) {
+	if (!IsPatchValid(pGenerator, pPatch)) {
+		return "field out of the generator constraints";
+	}
+	if (!IsSinglePatchDumpable(pPatch)) {
+		return "not dumpable";
+	}
+
+	unsigned char message[SINGLE_PATCH_SYSEX_LENGTH];
+	EncodeSinglePatchData(pPatch, programNumber, message);
+	if (FindSinglePatchData(message, SINGLE_PATCH_SYSEX_LENGTH, 0) != 0 || message[SINGLE_PATCH_SYSEX_LENGTH - 1] != SYSEX_EOX
+		|| message[PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH - 1] != programNumber) {
+		return "encoded intro or EOX";
+	}
+	for (int i = 1; i < SINGLE_PATCH_SYSEX_LENGTH - 1; i++) {
+		if (message[i] >= 0x80) {
+			return "status byte in the encoded data";
+		}
+	}
+
+	SinglePatch repacked;
+	RepackSinglePatchData(message + PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH, &repacked);
+	if (memcmp(&repacked, pPatch, OBWORDS_DATA_LENGTH) != 0) {
+		return "repacked data differ";
+	}
+	for (int i = 0; i < PATCHNAME_LENGTH; i++) {
+		if (repacked.name.character[i] != pPatch->name.character[i]) {
+			return "repacked name differs";
+		}
+	}
+	return NULL;
+}
+
+//----------------------------------------------------------------------------
+int _tmain(int argc, _TCHAR* argv[])
+{
+	int patchCount = (argc > 1) ? _ttoi(argv[1]) : DEFAULT_PATCH_COUNT;
+	unsigned int seed = (argc > 2) ? (unsigned int)_ttoi(argv[2]) : DEFAULT_SEED;
+	if (patchCount <= 0) {
+		fprintf(stderr, "Please specify a patch count!\n");
+		return 1;
+	}
+
+	SinglePatch* pParents = (SinglePatch*)malloc(PARENT_COUNT * sizeof(SinglePatch));
+	SinglePatch* pPatches = (SinglePatch*)malloc(BATCH_SIZE * sizeof(SinglePatch));
+	if (pParents == NULL || pPatches == NULL) {
+		fprintf(stderr, "Not enough memory!\n");
+		return 1;
+	}
+	BuildParents(pParents, PARENT_COUNT, seed);
+
+	int failureCount = 0;
+	for (int r = 0; r < RATES_COUNT; r++) {
+		PatchGenerator generator;
+		if (!InitPatchGenerator(&generator, pParents, PARENT_COUNT, seed + r)) {
+			fprintf(stderr, "Not enough memory!\n");
+			return 1;
+		}
+		SetMutationRate(&generator, 0, OBWORDS_DATA_LENGTH, RATES[r].mutationRate);
+		SetCrossoverRate(&generator, RATES[r].crossoverRate);
+
+		int invalidCount = 0;
+		for (int n = 0; n < patchCount; n += BATCH_SIZE) {
+			int batchCount = (patchCount - n < BATCH_SIZE) ? patchCount - n : BATCH_SIZE;
+			GeneratePatches(&generator, pPatches, batchCount);
+			for (int i = 0; i < batchCount; i++) {
+				const char* pszError = CheckGeneratedPatch(&generator, &pPatches[i], (unsigned char)((n + i) % 100));
+				if (pszError != NULL && invalidCount++ == 0) {
+					fprintf(stderr, "mutation %.2f crossover %.2f: patch %d: %s!\n", RATES[r].mutationRate,
+						RATES[r].crossoverRate, n + i, pszError);
+				}
+			}
+		}
+		ReleasePatchGenerator(&generator);
+
+		if (invalidCount > 0) {
+			fprintf(stderr, "mutation %.2f crossover %.2f: %d of %d patches wrong!\n", RATES[r].mutationRate,
+				RATES[r].crossoverRate, invalidCount, patchCount);
+			failureCount++;
+		}
+		else {
+			fprintf(stdout, "mutation %.2f crossover %.2f: %d patches valid\n", RATES[r].mutationRate,
+				RATES[r].crossoverRate, patchCount);
+		}
+	}
+
+	free(pPatches);
+	free(pParents);
+	return (failureCount == 0) ? 0 : 1;
+}
@@ -0,0 +1,373 @@
+//This file is part of XpanderSinglePatchViewer
+
+//XpanderSinglePatchViewer is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//XpanderSinglePatchViewer is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with XpanderSinglePatchViewer.
+//If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+//stdlib
+#include <stdlib.h>
+#include <string.h>
+
+#include "XpanderCapture.h"
+
+// MIDI inputs are polled for idleness at this period, in milliseconds
+static const DWORD CAPTURE_MIDI_POLL_PERIOD = 100;
+
+static const char* DOUBLE_LINE = "===========================\n";
+
+//----------------------------------------------------------------------------
+void InitCapture(Capture* pCapture, const char* pszDirectory, DWORD idleTimeout) {
+	memset(pCapture, 0, sizeof(Capture));
+	strcpy_s(pCapture->szDirectory, MAX_PATH, pszDirectory);
+	pCapture->idleTimeout = idleTimeout;
+
+	SYSTEMTIME now;
+	GetLocalTime(&now);
+	sprintf_s(pCapture->szTimestamp, sizeof(pCapture->szTimestamp), "%04d%02d%02d_%02d%02d%02d",
+		now.wYear, now.wMonth, now.wDay, now.wHour, now.wMinute, now.wSecond);
+	QueryPerformanceFrequency(&pCapture->frequency);
+}
+
+//----------------------------------------------------------------------------
+/*! Open a MIDI input and give it all its system exclusive buffers
+@return false if the input can not be opened
+*/
+static bool OpenMidiInput(CaptureDevice* pDevice, UINT deviceId) {
+	pDevice->hMidiEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+	if (pDevice->hMidiEvent == NULL) {
+		return false;
+	}
+	if (midiInOpen(&pDevice->hMidiIn, deviceId, (DWORD_PTR)pDevice->hMidiEvent, 0, CALLBACK_EVENT) != MMSYSERR_NOERROR) {
+		pDevice->hMidiIn = NULL;
+		return false;
+	}
+	for (int i = 0; i < CAPTURE_MIDI_BUFFER_COUNT; i++) {
+		MIDIHDR* pHeader = &pDevice->midiHeaders[i];
+		pHeader->lpData = (LPSTR)pDevice->midiBuffers[i];
+		pHeader->dwBufferLength = CAPTURE_MIDI_BUFFER_SIZE;
+		if (midiInPrepareHeader(pDevice->hMidiIn, pHeader, sizeof(MIDIHDR)) != MMSYSERR_NOERROR
+			|| midiInAddBuffer(pDevice->hMidiIn, pHeader, sizeof(MIDIHDR)) != MMSYSERR_NOERROR) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//----------------------------------------------------------------------------
+bool AddCaptureDevice(Capture* pCapture, const char* pszSource) {
+	if (pCapture->deviceCount >= CAPTURE_MAX_DEVICES) {
+		return false;
+	}
+	CaptureDevice* pDevice = (CaptureDevice*)calloc(1, sizeof(CaptureDevice));
+	if (pDevice == NULL) {
+		return false;
+	}
+	// released by ReleaseCapture() even if not completely opened
+	pCapture->pDevices[pCapture->deviceCount] = pDevice;
+	pDevice->index = pCapture->deviceCount++;
+	strcpy_s(pDevice->szSource, MAX_PATH, pszSource);
+	pDevice->hStream = INVALID_HANDLE_VALUE;
+	pDevice->frequency = pCapture->frequency.QuadPart;
+	pDevice->idleTicks = (LONGLONG)pCapture->idleTimeout * pDevice->frequency / 1000;
+	InitSinglePatchScanner(&pDevice->scanner);
+
+	size_t prefixLength = strlen(CAPTURE_MIDI_PREFIX);
+	if (strncmp(pszSource, CAPTURE_MIDI_PREFIX, prefixLength) == 0) {
+		pDevice->type = CAPTURE_SOURCE_MIDI;
+		if (!OpenMidiInput(pDevice, (UINT)atoi(pszSource + prefixLength))) {
+			return false;
+		}
+	}
+	else {
+		pDevice->type = CAPTURE_SOURCE_STREAM;
+		pDevice->hStream = CreateFile(pszSource, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL, NULL);
+		if (pDevice->hStream == INVALID_HANDLE_VALUE) {
+			return false;
+		}
+	}
+
+	char szIndexFileName[MAX_PATH];
+	sprintf_s(pDevice->szArchiveFileName, MAX_PATH, "%s\\device%d_%s.syx", pCapture->szDirectory, pDevice->index, pCapture->szTimestamp);
+	sprintf_s(szIndexFileName, MAX_PATH, "%s\\device%d_%s.txt", pCapture->szDirectory, pDevice->index, pCapture->szTimestamp);
+	fopen_s(&pDevice->pArchive, pDevice->szArchiveFileName, "wb");
+	fopen_s(&pDevice->pIndex, szIndexFileName, "w");
+	if (pDevice->pArchive == NULL || pDevice->pIndex == NULL) {
+		return false;
+	}
+	fprintf(pDevice->pIndex, "# %s, capture started %s\n", pszSource, pCapture->szTimestamp);
+	fprintf(pDevice->pIndex, "# seconds\toffset\tprogram\tname\tstatus\n");
+	return true;
+}
+
+//----------------------------------------------------------------------------
+/*! Scanner callback: archive a complete single patch message, the scanner
+keeps all but the EOX
+*/
+static void ArchiveSinglePatch(void* pUser, unsigned long long offset, const unsigned char* pMessage, const SinglePatch* pPatch) {
+	CaptureDevice* pDevice = (CaptureDevice*)pUser;
+	char szName[PATCHNAME_LENGTH + 1];
+	for (int i = 0; i <= PATCHNAME_LENGTH; i++) {
+		szName[i] = (char)pPatch->name.character[i];
+	}
+	bool bValid = IsSinglePatchDumpable(pPatch);
+	fprintf(pDevice->pIndex, "%.6f\t%llu\t%02d\t%s\t%s\n", (double)(pDevice->chunkTicks - pDevice->startTicks) / pDevice->frequency,
+		offset, pMessage[PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH - 1], szName, bValid ? "OK" : "INVALID");
+	fwrite(pMessage, 1, SINGLE_PATCH_SYSEX_LENGTH - 1, pDevice->pArchive);
+	fwrite(&SYSEX_EOX, 1, 1, pDevice->pArchive);
+
+	// when was the F0 read: latest read starting at or before it
+	LONGLONG firstByteTicks = pDevice->chunkTicks;
+	unsigned long long oldest = (pDevice->chunkCount > (unsigned long long)CAPTURE_CHUNK_HISTORY)
+		? pDevice->chunkCount - CAPTURE_CHUNK_HISTORY : 0;
+	for (unsigned long long i = pDevice->chunkCount; i > oldest; i--) {
+		const CaptureChunk* pChunk = &pDevice->chunks[(i - 1) % CAPTURE_CHUNK_HISTORY];
+		firstByteTicks = pChunk->ticks;
+		if (pChunk->offset <= offset) {
+			break;
+		}
+	}
+
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+	LONGLONG latency = now.QuadPart - firstByteTicks;
+	LONGLONG processing = now.QuadPart - pDevice->chunkTicks;
+	if (pDevice->patchCount == 0 || latency < pDevice->minLatency) {
+		pDevice->minLatency = latency;
+	}
+	if (latency > pDevice->maxLatency) {
+		pDevice->maxLatency = latency;
+	}
+	if (processing > pDevice->maxProcessing) {
+		pDevice->maxProcessing = processing;
+	}
+	pDevice->totalLatency += latency;
+	pDevice->totalProcessing += processing;
+	pDevice->patchCount++;
+	if (!bValid) {
+		pDevice->invalidCount++;
+	}
+}
+
+//----------------------------------------------------------------------------
+/*! Give the bytes of a read to the decode pipeline
+*/
+static void FeedCaptureDevice(CaptureDevice* pDevice, const unsigned char* pData, size_t size) {
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+	if (pDevice->byteCount == 0) {
+		pDevice->firstTicks = now.QuadPart;
+	}
+	pDevice->lastTicks = now.QuadPart;
+	pDevice->chunkTicks = now.QuadPart;
+
+	CaptureChunk* pChunk = &pDevice->chunks[pDevice->chunkCount % CAPTURE_CHUNK_HISTORY];
+	pChunk->offset = pDevice->byteCount;
+	pChunk->ticks = now.QuadPart;
+	pDevice->chunkCount++;
+
+	FeedSinglePatchScanner(&pDevice->scanner, pData, size, ArchiveSinglePatch, pDevice);
+	pDevice->byteCount += size;
+}
+
+//----------------------------------------------------------------------------
+/*! Read a named pipe or a file until its end
+*/
+static void CaptureStream(CaptureDevice* pDevice) {
+	unsigned char buffer[CAPTURE_READ_SIZE];
+	for (;;) {
+		DWORD readSize = 0;
+		if (!ReadFile(pDevice->hStream, buffer, CAPTURE_READ_SIZE, &readSize, NULL)) {
+			DWORD error = GetLastError();
+			if (error != ERROR_MORE_DATA) {
+				// the writer closing a pipe is its normal end
+				pDevice->bReadError = (error != ERROR_BROKEN_PIPE);
+				break;
+			}
+		}
+		else if (readSize == 0) {
+			break;
+		}
+		FeedCaptureDevice(pDevice, buffer, readSize);
+	}
+}
+
+//----------------------------------------------------------------------------
+/*! Read a MIDI input until it is idle
+*/
+static void CaptureMidiInput(CaptureDevice* pDevice) {
+	if (midiInStart(pDevice->hMidiIn) != MMSYSERR_NOERROR) {
+		pDevice->bReadError = true;
+		return;
+	}
+	LONGLONG lastDataTicks = pDevice->startTicks;
+	// buffers are done in the order they were added
+	int next = 0;
+	for (;;) {
+		WaitForSingleObject(pDevice->hMidiEvent, CAPTURE_MIDI_POLL_PERIOD);
+		while ((pDevice->midiHeaders[next].dwFlags & MHDR_DONE) == MHDR_DONE) {
+			MIDIHDR* pHeader = &pDevice->midiHeaders[next];
+			if (pHeader->dwBytesRecorded > 0) {
+				FeedCaptureDevice(pDevice, (const unsigned char*)pHeader->lpData, pHeader->dwBytesRecorded);
+				lastDataTicks = pDevice->lastTicks;
+			}
+			pHeader->dwBytesRecorded = 0;
+			midiInAddBuffer(pDevice->hMidiIn, pHeader, sizeof(MIDIHDR));
+			next = (next + 1) % CAPTURE_MIDI_BUFFER_COUNT;
+		}
+		LARGE_INTEGER now;
+		QueryPerformanceCounter(&now);
+		if (now.QuadPart - lastDataTicks > pDevice->idleTicks) {
+			break;
+		}
+	}
+	midiInStop(pDevice->hMidiIn);
+}
+
+//----------------------------------------------------------------------------
+/*! Thread: capture one device
+*/
+static DWORD WINAPI CaptureThreadProc(LPVOID pParameter) {
+	CaptureDevice* pDevice = (CaptureDevice*)pParameter;
+	if (pDevice->type == CAPTURE_SOURCE_MIDI) {
+		CaptureMidiInput(pDevice);
+	}
+	else {
+		CaptureStream(pDevice);
+	}
+	EndSinglePatchScanner(&pDevice->scanner);
+	pDevice->truncatedCount = pDevice->scanner.truncatedCount;
+	fflush(pDevice->pArchive);
+	fflush(pDevice->pIndex);
+	return 0;
+}
+
+//----------------------------------------------------------------------------
+bool RunCapture(Capture* pCapture) {
+	HANDLE threads[CAPTURE_MAX_DEVICES];
+	int threadCount = 0;
+	bool bOk = true;
+
+	QueryPerformanceCounter(&pCapture->startTicks);
+	for (int i = 0; i < pCapture->deviceCount; i++) {
+		CaptureDevice* pDevice = pCapture->pDevices[i];
+		pDevice->startTicks = pCapture->startTicks.QuadPart;
+		pDevice->hThread = CreateThread(NULL, 0, CaptureThreadProc, pDevice, 0, NULL);
+		if (pDevice->hThread == NULL) {
+			bOk = false;
+			break;
+		}
+		threads[threadCount++] = pDevice->hThread;
+	}
+	if (threadCount > 0) {
+		WaitForMultipleObjects(threadCount, threads, TRUE, INFINITE);
+	}
+	QueryPerformanceCounter(&pCapture->stopTicks);
+	return bOk;
+}
+
+//----------------------------------------------------------------------------
+void PrintCaptureReport(const Capture* pCapture, OutputSink* pSink) {
+	double frequency = (double)pCapture->frequency.QuadPart;
+	unsigned long long totalBytes = 0;
+	unsigned long long totalPatches = 0;
+	unsigned long long totalInvalid = 0;
+	unsigned long long totalTruncated = 0;
+	LONGLONG totalLatency = 0;
+	LONGLONG minLatency = 0;
+	LONGLONG maxLatency = 0;
+	LONGLONG maxProcessing = 0;
+	double slowestSeconds = 0.0;
+
+	SinkPrintf(pSink, DOUBLE_LINE);
+	SinkPrintf(pSink, "%-3s %-24s %8s %10s %9s %10s %9s %27s %10s\n", "DEV", "SOURCE", "PATCHES", "BYTES", "SECONDS",
+		"PATCHES/S", "KB/S", "LATENCY ms MIN/MEAN/MAX", "PROC us");
+	for (int i = 0; i < pCapture->deviceCount; i++) {
+		const CaptureDevice* pDevice = pCapture->pDevices[i];
+		// first read to last read
+		double seconds = (pDevice->byteCount > 0) ? (pDevice->lastTicks - pDevice->firstTicks) / frequency : 0.0;
+		double patchCount = (pDevice->patchCount > 0) ? (double)pDevice->patchCount : 1.0;
+		SinkPrintf(pSink, "%-3d %-24.24s %8llu %10llu %9.3f %10.0f %9.1f %8.3f/%8.3f/%8.3f %10.1f%s\n", pDevice->index, pDevice->szSource,
+			pDevice->patchCount, pDevice->byteCount, seconds,
+			(seconds > 0.0) ? pDevice->patchCount / seconds : 0.0, (seconds > 0.0) ? pDevice->byteCount / seconds / 1024.0 : 0.0,
+			1000.0 * pDevice->minLatency / frequency, 1000.0 * pDevice->totalLatency / patchCount / frequency,
+			1000.0 * pDevice->maxLatency / frequency, 1000000.0 * pDevice->totalProcessing / patchCount / frequency,
+			pDevice->bReadError ? " READ ERROR" : "");
+
+		totalBytes += pDevice->byteCount;
+		totalPatches += pDevice->patchCount;
+		totalInvalid += pDevice->invalidCount;
+		totalTruncated += pDevice->truncatedCount;
+		totalLatency += pDevice->totalLatency;
+		if (pDevice->patchCount > 0 && (minLatency == 0 || pDevice->minLatency < minLatency)) {
+			minLatency = pDevice->minLatency;
+		}
+		if (pDevice->maxLatency > maxLatency) {
+			maxLatency = pDevice->maxLatency;
+		}
+		if (pDevice->maxProcessing > maxProcessing) {
+			maxProcessing = pDevice->maxProcessing;
+		}
+		if (seconds > slowestSeconds) {
+			slowestSeconds = seconds;
+		}
+	}
+
+	// wall time includes the MIDI inputs idle timeout
+	double wallSeconds = (pCapture->stopTicks.QuadPart - pCapture->startTicks.QuadPart) / frequency;
+	double patchCount = (totalPatches > 0) ? (double)totalPatches : 1.0;
+	SinkPrintf(pSink, DOUBLE_LINE);
+	SinkPrintf(pSink, "Devices:\t %d\n", pCapture->deviceCount);
+	SinkPrintf(pSink, "Patches:\t %llu (%llu with out of range values), %llu truncated\n", totalPatches, totalInvalid, totalTruncated);
+	SinkPrintf(pSink, "Bytes:\t\t %llu\n", totalBytes);
+	SinkPrintf(pSink, "Wall time:\t %.3f s, slowest device %.3f s\n", wallSeconds, slowestSeconds);
+	SinkPrintf(pSink, "Throughput:\t %.0f patches/s, %.1f KB/s\n", (wallSeconds > 0.0) ? totalPatches / wallSeconds : 0.0,
+		(wallSeconds > 0.0) ? totalBytes / wallSeconds / 1024.0 : 0.0);
+	SinkPrintf(pSink, "Latency:\t %.3f/%.3f/%.3f ms (min/mean/max, first byte read to patch archived)\n",
+		1000.0 * minLatency / frequency, 1000.0 * totalLatency / patchCount / frequency, 1000.0 * maxLatency / frequency);
+	SinkPrintf(pSink, "Processing:\t %.1f us max (last byte read to patch archived)\n", 1000000.0 * maxProcessing / frequency);
+}
+
+//----------------------------------------------------------------------------
+void ReleaseCapture(Capture* pCapture) {
+	for (int i = 0; i < pCapture->deviceCount; i++) {
+		CaptureDevice* pDevice = pCapture->pDevices[i];
+		if (pDevice->hThread != NULL) {
+			CloseHandle(pDevice->hThread);
+		}
+		if (pDevice->hMidiIn != NULL) {
+			// gives back all the buffers
+			midiInReset(pDevice->hMidiIn);
+			for (int j = 0; j < CAPTURE_MIDI_BUFFER_COUNT; j++) {
+				midiInUnprepareHeader(pDevice->hMidiIn, &pDevice->midiHeaders[j], sizeof(MIDIHDR));
+			}
+			midiInClose(pDevice->hMidiIn);
+		}
+		if (pDevice->hMidiEvent != NULL) {
+			CloseHandle(pDevice->hMidiEvent);
+		}
+		if (pDevice->hStream != INVALID_HANDLE_VALUE) {
+			CloseHandle(pDevice->hStream);
+		}
+		if (pDevice->pArchive != NULL) {
+			fclose(pDevice->pArchive);
+		}
+		if (pDevice->pIndex != NULL) {
+			fclose(pDevice->pIndex);
+		}
+		free(pDevice);
+	}
+	pCapture->deviceCount = 0;
+}
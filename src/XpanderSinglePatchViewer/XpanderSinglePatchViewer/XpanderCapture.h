@@ -0,0 +1,155 @@
+//This file is part of XpanderSinglePatchViewer
+
+//XpanderSinglePatchViewer is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//XpanderSinglePatchViewer is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with XpanderSinglePatchViewer.
+//If not, see <http://www.gnu.org/licenses/>.
+
+//============================================================================
+// Concurrent capture of several MIDI inputs: each device has its own reader
+// thread, single patch scanner, archive files and statistics, so that the
+// threads share nothing while capturing. The statistics are only read by the
+// main thread once all the threads are done.
+// A device is either a raw MIDI input (winmm) or a byte stream that can be
+// read with ReadFile(): a named pipe (e.g. \\.\pipe\xpander1) or a file.
+//============================================================================
+
+#ifndef _XPANDERCAPTURE__
+#define _XPANDERCAPTURE__
+
+#include <windows.h>
+#include <mmsystem.h>
+
+#include "XpanderSinglePatch.h"
+#include "XpanderOutputSink.h"
+
+// WaitForMultipleObjects() limit is 64
+static const int CAPTURE_MAX_DEVICES = 16;
+// source prefix of a MIDI input, followed by the winmm device number
+static const char* CAPTURE_MIDI_PREFIX = "midi:";
+// winmm system exclusive buffers per MIDI input
+static const int CAPTURE_MIDI_BUFFER_COUNT = 8;
+static const int CAPTURE_MIDI_BUFFER_SIZE = 1024;
+// stream reads size
+static const int CAPTURE_READ_SIZE = 4096;
+// reads remembered to find when the first byte of a message was read
+static const int CAPTURE_CHUNK_HISTORY = 512;
+// default time without data after which a MIDI input capture stops
+static const DWORD CAPTURE_DEFAULT_IDLE_TIMEOUT = 30000;
+
+// CaptureSourceTypes
+typedef enum _CaptureSourceTypes {
+	CAPTURE_SOURCE_STREAM,	// named pipe or file, captured until its end
+	CAPTURE_SOURCE_MIDI		// MIDI input, captured until idle
+} CaptureSourceTypes;
+
+// a read and its time
+typedef struct _CaptureChunk {
+	unsigned long long offset;	// stream offset of the first byte read
+	LONGLONG ticks;				// performance counter after the read
+} CaptureChunk;
+
+typedef struct _CaptureDevice {
+	// set by AddCaptureDevice()
+	int index;
+	char szSource[MAX_PATH];
+	CaptureSourceTypes type;
+	HANDLE hStream;					// CAPTURE_SOURCE_STREAM
+	HMIDIIN hMidiIn;				// CAPTURE_SOURCE_MIDI
+	HANDLE hMidiEvent;				// signaled by winmm when a buffer is done
+	MIDIHDR midiHeaders[CAPTURE_MIDI_BUFFER_COUNT];
+	unsigned char midiBuffers[CAPTURE_MIDI_BUFFER_COUNT][CAPTURE_MIDI_BUFFER_SIZE];
+	char szArchiveFileName[MAX_PATH];
+	FILE* pArchive;					// captured single patch messages
+	FILE* pIndex;					// one line per captured patch
+	LONGLONG startTicks;			// capture start
+	LONGLONG idleTicks;				// MIDI input idle timeout
+	LONGLONG frequency;				// performance counter frequency
+	HANDLE hThread;
+
+	// decode pipeline, only used by the device thread
+	SinglePatchScanner scanner;
+	CaptureChunk chunks[CAPTURE_CHUNK_HISTORY];
+	unsigned long long chunkCount;	// reads so far
+	LONGLONG chunkTicks;			// time of the read being scanned
+
+	// statistics, only written by the device thread
+	unsigned long long byteCount;
+	unsigned long long patchCount;
+	unsigned long long invalidCount;	// patches with out of range values, archived anyway
+	unsigned long long truncatedCount;	// messages cut before their EOX, not archived (set at the end)
+	LONGLONG firstTicks;				// first read
+	LONGLONG lastTicks;					// last read
+	LONGLONG minLatency;				// first byte read to patch archived
+	LONGLONG maxLatency;
+	LONGLONG totalLatency;
+	LONGLONG maxProcessing;				// last byte read to patch archived
+	LONGLONG totalProcessing;
+	bool bReadError;
+} CaptureDevice;
+
+typedef struct _Capture {
+	CaptureDevice* pDevices[CAPTURE_MAX_DEVICES];	// one allocation each: no false sharing
+	int deviceCount;
+	char szDirectory[MAX_PATH];		// archives directory
+	char szTimestamp[32];			// capture start, in the archive names
+	DWORD idleTimeout;				// in milliseconds
+	LARGE_INTEGER frequency;
+	LARGE_INTEGER startTicks;
+	LARGE_INTEGER stopTicks;
+} Capture;
+
+//----------------------------------------------------------------------------
+/*! Initialize a capture
+@param [out] pCapture: the capture
+@param [in] pszDirectory: where to write the archives
+@param [in] idleTimeout: time without data after which a MIDI input capture
+stops, in milliseconds
+*/
+void InitCapture(Capture* pCapture, const char* pszDirectory, DWORD idleTimeout);
+
+//----------------------------------------------------------------------------
+/*! Open a device and its archives:
+<directory>\device<n>_<YYYYMMDD_HHMMSS>.syx, the captured single patch
+messages, and <directory>\device<n>_<YYYYMMDD_HHMMSS>.txt, one line per
+patch: seconds since the capture start, stream offset, program, name, status
+(OK, or INVALID for out of range values). Messages cut before their EOX are
+not archived, only counted in the report.
+@param [in] pCapture: the capture
+@param [in] pszSource: "midi:<n>" for the MIDI input n, otherwise a named
+pipe or file name
+@return false if the device or its archives can not be opened
+*/
+bool AddCaptureDevice(Capture* pCapture, const char* pszSource);
+
+//----------------------------------------------------------------------------
+/*! Capture all the devices at the same time, one thread each, until all the
+streams are ended and all the MIDI inputs are idle
+@param [in] pCapture: the capture
+@return false if a thread can not be started
+*/
+bool RunCapture(Capture* pCapture);
+
+//----------------------------------------------------------------------------
+/*! Write per device and aggregate throughput and latency
+@param [in] pCapture: the capture, after RunCapture()
+@param [in] pSink: where to write to
+*/
+void PrintCaptureReport(const Capture* pCapture, OutputSink* pSink);
+
+//----------------------------------------------------------------------------
+/*! Close the devices and archives
+@param [in] pCapture: the capture
+*/
+void ReleaseCapture(Capture* pCapture);
+
+#endif // _XPANDERCAPTURE__
@@ -0,0 +1,452 @@
+//This file is part of XpanderSinglePatchViewer
+
+//XpanderSinglePatchViewer is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//XpanderSinglePatchViewer is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with XpanderSinglePatchViewer.
+//If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+//stdlib
+#include <stdlib.h>
+#include <string.h>
+
+#include "XpanderDecodeCache.h"
+#include "XpanderSinglePatch.h"
+#include "XpanderHash.h"
+
+// file identification
+static const unsigned int DECODE_CACHE_MAGIC = 0x43445058;	// "XPDC"
+static const unsigned int DECODE_CACHE_INDEX_MAGIC = 0x49445058;	// "XPDI"
+static const unsigned int DECODE_CACHE_VERSION = 1;
+
+// .xdc file: header, then patchCount offsets, patchCount SinglePatch records
+// and patchCount program numbers
+typedef struct _DecodeCacheHeader {
+	unsigned int magic;
+	unsigned int version;
+	unsigned int recordSize;		// sizeof(SinglePatch) of the writer
+	unsigned int patchCount;
+	unsigned long long sourceHash;	// content hash of the sysex file
+	unsigned long long sourceSize;	// size of the sysex file
+} DecodeCacheHeader;
+
+// .idx file
+typedef struct _DecodeCacheIndex {
+	unsigned int magic;
+	unsigned int version;
+	unsigned long long sourceSize;
+	unsigned long long sourceWriteTime;
+	unsigned long long sourceHash;
+} DecodeCacheIndex;
+
+// temporary files older than this are left over by crashed runs
+static const unsigned long long DECODE_CACHE_STALE_TEMP_AGE = 3600ULL * 10000000;	// 1 hour, in FILETIME units
+// longest name appended to the directory: "\<16 hex digits>.xdc.<process id>.tmp"
+static const size_t DECODE_CACHE_MAX_NAME_LENGTH = 1 + 16 + 4 + 1 + 10 + 4;
+
+//----------------------------------------------------------------------------
+/*! Size of a .xdc file holding some patches
+*/
+static size_t GetCacheImageSize(int patchCount) {
+	return sizeof(DecodeCacheHeader) + patchCount * (sizeof(unsigned long long) + sizeof(SinglePatch) + sizeof(unsigned char));
+}
+
+//----------------------------------------------------------------------------
+/*! Point a DecodedFile to the arrays of a .xdc file image
+@return false if the image is not a valid .xdc file
+*/
+static bool AttachCacheImage(const void* pImage, size_t imageSize, unsigned long long sourceHash, DecodedFile* pDecoded) {
+	const DecodeCacheHeader* pHeader = (const DecodeCacheHeader*)pImage;
+	if (imageSize < sizeof(DecodeCacheHeader)
+		|| pHeader->magic != DECODE_CACHE_MAGIC
+		|| pHeader->version != DECODE_CACHE_VERSION
+		|| pHeader->recordSize != sizeof(SinglePatch)
+		|| pHeader->sourceHash != sourceHash
+		|| GetCacheImageSize(pHeader->patchCount) != imageSize) {
+		return false;
+	}
+	const unsigned char* pArrays = (const unsigned char*)(pHeader + 1);
+	pDecoded->patchCount = pHeader->patchCount;
+	pDecoded->pOffsets = (const unsigned long long*)pArrays;
+	pDecoded->pPatches = (const SinglePatch*)(pArrays + pHeader->patchCount * sizeof(unsigned long long));
+	pDecoded->pProgramNumbers = (const unsigned char*)(pDecoded->pPatches + pHeader->patchCount);
+	return true;
+}
+
+//----------------------------------------------------------------------------
+/*! Write a whole file, crash-safe: the data are written to a temporary
+file which then replaces the destination file.
+*/
+static bool WriteFileAtomically(const char* pszPath, const void* pData, size_t size) {
+	char szTempPath[MAX_PATH];
+	sprintf_s(szTempPath, MAX_PATH, "%s.%lu.tmp", pszPath, GetCurrentProcessId());
+
+	HANDLE hFile = CreateFile(szTempPath, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	bool bWritten = true;
+	const unsigned char* pByte = (const unsigned char*)pData;
+	while (bWritten && size > 0) {
+		DWORD toWrite = (size > 0x40000000) ? 0x40000000 : (DWORD)size;
+		DWORD written = 0;
+		bWritten = (WriteFile(hFile, pByte, toWrite, &written, NULL) != FALSE) && (written == toWrite);
+		pByte += written;
+		size -= written;
+	}
+	bWritten = bWritten && (FlushFileBuffers(hFile) != FALSE);
+	CloseHandle(hFile);
+
+	if (!bWritten || !MoveFileEx(szTempPath, pszPath, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+		DeleteFile(szTempPath);
+		return false;
+	}
+	return true;
+}
+
+//----------------------------------------------------------------------------
+/*! Read a whole small file
+@return false if the file can not be read or has another size
+*/
+static bool ReadWholeFile(const char* pszPath, void* pData, size_t size) {
+	FILE* pFile = NULL;
+	fopen_s(&pFile, pszPath, "rb");
+	if (pFile == NULL) {
+		return false;
+	}
+	bool bRead = (fread(pData, 1, size, pFile) == size) && (fgetc(pFile) == EOF);
+	fclose(pFile);
+	return bRead;
+}
+
+//----------------------------------------------------------------------------
+/*! Mark a cache file as recently used: last write time is the last use time
+*/
+static void TouchCacheFile(const char* pszPath) {
+	HANDLE hFile = CreateFile(pszPath, FILE_WRITE_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE) {
+		return;
+	}
+	FILETIME now;
+	GetSystemTimeAsFileTime(&now);
+	SetFileTime(hFile, NULL, NULL, &now);
+	CloseHandle(hFile);
+}
+
+//----------------------------------------------------------------------------
+/*! Map the .xdc file of a content hash, and mark it as recently used
+@return false if there is no valid cache file for this hash
+*/
+static bool MapCacheFile(DecodeCache* pCache, unsigned long long sourceHash, DecodedFile* pDecoded) {
+	char szPath[MAX_PATH];
+	sprintf_s(szPath, MAX_PATH, "%s\\%016llX.xdc", pCache->szDirectory, sourceHash);
+
+	HANDLE hFile = CreateFile(szPath, GENERIC_READ | FILE_WRITE_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_DELETE,
+		NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart < (LONGLONG)sizeof(DecodeCacheHeader)) {
+		CloseHandle(hFile);
+		return false;
+	}
+
+	// LRU: last write time is the last use time
+	FILETIME now;
+	GetSystemTimeAsFileTime(&now);
+	SetFileTime(hFile, NULL, NULL, &now);
+
+	HANDLE hMapping = CreateFileMapping(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(hFile);
+	if (hMapping == NULL) {
+		return false;
+	}
+	const void* pView = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+	if (pView == NULL || !AttachCacheImage(pView, (size_t)fileSize.QuadPart, sourceHash, pDecoded)) {
+		if (pView != NULL) {
+			UnmapViewOfFile(pView);
+		}
+		CloseHandle(hMapping);
+		return false;
+	}
+	pDecoded->hMapping = hMapping;
+	pDecoded->pView = pView;
+	return true;
+}
+
+//----------------------------------------------------------------------------
+bool InitDecodeCache(DecodeCache* pCache, const char* pszDirectory, unsigned long long maxSize) {
+	memset(pCache, 0, sizeof(DecodeCache));
+	if (strlen(pszDirectory) + DECODE_CACHE_MAX_NAME_LENGTH >= MAX_PATH) {
+		return false;
+	}
+	strcpy_s(pCache->szDirectory, MAX_PATH, pszDirectory);
+	pCache->maxSize = maxSize;
+
+	if (!CreateDirectory(pszDirectory, NULL) && GetLastError() != ERROR_ALREADY_EXISTS) {
+		return false;
+	}
+	return true;
+}
+
+//----------------------------------------------------------------------------
+// single patches found while decoding a file
+typedef struct _DecodedArrays {
+	unsigned long long* pOffsets;
+	unsigned char* pProgramNumbers;
+	SinglePatch* pPatches;
+	int count;
+	int capacity;
+	bool bOutOfMemory;
+} DecodedArrays;
+
+//----------------------------------------------------------------------------
+/*! Scanner callback: append the patch to a DecodedArrays
+*/
+static void AppendDecodedPatch(void* pUser, unsigned long long offset, const unsigned char* pIntro, const SinglePatch* pPatch) {
+	DecodedArrays* pArrays = (DecodedArrays*)pUser;
+	if (pArrays->count == pArrays->capacity) {
+		int capacity = (pArrays->capacity == 0) ? 128 : pArrays->capacity * 2;
+		unsigned long long* pOffsets = (unsigned long long*)realloc(pArrays->pOffsets, capacity * sizeof(unsigned long long));
+		if (pOffsets != NULL) { pArrays->pOffsets = pOffsets; }
+		unsigned char* pProgramNumbers = (unsigned char*)realloc(pArrays->pProgramNumbers, capacity * sizeof(unsigned char));
+		if (pProgramNumbers != NULL) { pArrays->pProgramNumbers = pProgramNumbers; }
+		SinglePatch* pPatches = (SinglePatch*)realloc(pArrays->pPatches, capacity * sizeof(SinglePatch));
+		if (pPatches != NULL) { pArrays->pPatches = pPatches; }
+		if (pOffsets == NULL || pProgramNumbers == NULL || pPatches == NULL) {
+			pArrays->bOutOfMemory = true;
+			return;
+		}
+		pArrays->capacity = capacity;
+	}
+	pArrays->pOffsets[pArrays->count] = offset;
+	pArrays->pProgramNumbers[pArrays->count] = pIntro[5];
+	pArrays->pPatches[pArrays->count] = *pPatch;
+	pArrays->count++;
+}
+
+//----------------------------------------------------------------------------
+/*! Decode a sysex file content into a .xdc file image
+@return the image, allocated with malloc, NULL on memory allocation error
+*/
+static void* BuildCacheImage(const unsigned char* pData, size_t size, unsigned long long sourceHash, size_t* pImageSize) {
+	DecodedArrays arrays;
+	memset(&arrays, 0, sizeof(DecodedArrays));
+	SinglePatchScanner scanner;
+	InitSinglePatchScanner(&scanner);
+	FeedSinglePatchScanner(&scanner, pData, size, AppendDecodedPatch, &arrays);
+
+	void* pImage = NULL;
+	if (!arrays.bOutOfMemory) {
+		*pImageSize = GetCacheImageSize(arrays.count);
+		pImage = malloc(*pImageSize);
+	}
+	if (pImage != NULL) {
+		DecodeCacheHeader* pHeader = (DecodeCacheHeader*)pImage;
+		pHeader->magic = DECODE_CACHE_MAGIC;
+		pHeader->version = DECODE_CACHE_VERSION;
+		pHeader->recordSize = sizeof(SinglePatch);
+		pHeader->patchCount = arrays.count;
+		pHeader->sourceHash = sourceHash;
+		pHeader->sourceSize = size;
+
+		unsigned char* pArray = (unsigned char*)(pHeader + 1);
+		memcpy(pArray, arrays.pOffsets, arrays.count * sizeof(unsigned long long));
+		pArray += arrays.count * sizeof(unsigned long long);
+		memcpy(pArray, arrays.pPatches, arrays.count * sizeof(SinglePatch));
+		pArray += arrays.count * sizeof(SinglePatch);
+		memcpy(pArray, arrays.pProgramNumbers, arrays.count * sizeof(unsigned char));
+	}
+
+	free(arrays.pOffsets);
+	free(arrays.pProgramNumbers);
+	free(arrays.pPatches);
+	return pImage;
+}
+
+//----------------------------------------------------------------------------
+bool DecodeFileCached(DecodeCache* pCache, const char* pszFileName, DecodedFile* pDecoded, bool* pbCacheHit) {
+	memset(pDecoded, 0, sizeof(DecodedFile));
+	*pbCacheHit = false;
+
+	// size and last write time of the file
+	WIN32_FILE_ATTRIBUTE_DATA attributes;
+	char szFullPath[MAX_PATH];
+	if (!GetFileAttributesEx(pszFileName, GetFileExInfoStandard, &attributes)
+		|| GetFullPathName(pszFileName, MAX_PATH, szFullPath, NULL) == 0) {
+		return false;
+	}
+	DecodeCacheIndex index;
+	memset(&index, 0, sizeof(DecodeCacheIndex));
+	index.magic = DECODE_CACHE_INDEX_MAGIC;
+	index.version = DECODE_CACHE_VERSION;
+	index.sourceSize = ((unsigned long long)attributes.nFileSizeHigh << 32) | attributes.nFileSizeLow;
+	index.sourceWriteTime = ((unsigned long long)attributes.ftLastWriteTime.dwHighDateTime << 32)
+		| attributes.ftLastWriteTime.dwLowDateTime;
+
+	// unchanged file: its content hash is known
+	char szIndexPath[MAX_PATH];
+	sprintf_s(szIndexPath, MAX_PATH, "%s\\%016llX.idx", pCache->szDirectory,
+		HashBytes(HASH_SEED, szFullPath, strlen(szFullPath)));
+	DecodeCacheIndex knownIndex;
+	if (ReadWholeFile(szIndexPath, &knownIndex, sizeof(DecodeCacheIndex))
+		&& knownIndex.magic == index.magic && knownIndex.version == index.version
+		&& knownIndex.sourceSize == index.sourceSize && knownIndex.sourceWriteTime == index.sourceWriteTime
+		&& MapCacheFile(pCache, knownIndex.sourceHash, pDecoded)) {
+		// the .idx is as recently used as its .xdc, or it would be evicted first
+		TouchCacheFile(szIndexPath);
+		*pbCacheHit = true;
+		return true;
+	}
+
+	// read and hash the file
+	FILE* pFile = NULL;
+	fopen_s(&pFile, pszFileName, "rb");
+	if (pFile == NULL) {
+		return false;
+	}
+	size_t size = (size_t)index.sourceSize;
+	unsigned char* pData = (unsigned char*)malloc(size > 0 ? size : 1);
+	bool bRead = (pData != NULL) && (fread(pData, 1, size, pFile) == size);
+	fclose(pFile);
+	if (!bRead) {
+		free(pData);
+		return false;
+	}
+	index.sourceHash = HashBytes(HASH_SEED, pData, size);
+	WriteFileAtomically(szIndexPath, &index, sizeof(DecodeCacheIndex));
+
+	// same content already decoded from another file
+	if (MapCacheFile(pCache, index.sourceHash, pDecoded)) {
+		free(pData);
+		*pbCacheHit = true;
+		return true;
+	}
+
+	// decode, then store
+	size_t imageSize = 0;
+	void* pImage = BuildCacheImage(pData, size, index.sourceHash, &imageSize);
+	free(pData);
+	if (pImage == NULL) {
+		return false;
+	}
+	char szPath[MAX_PATH];
+	sprintf_s(szPath, MAX_PATH, "%s\\%016llX.xdc", pCache->szDirectory, index.sourceHash);
+	if (WriteFileAtomically(szPath, pImage, imageSize)) {
+		EvictDecodeCache(pCache);
+	}
+	AttachCacheImage(pImage, imageSize, index.sourceHash, pDecoded);
+	pDecoded->pMemory = pImage;
+	return true;
+}
+
+//----------------------------------------------------------------------------
+void ReleaseDecodedFile(DecodedFile* pDecoded) {
+	if (pDecoded->pView != NULL) {
+		UnmapViewOfFile(pDecoded->pView);
+	}
+	if (pDecoded->hMapping != NULL) {
+		CloseHandle(pDecoded->hMapping);
+	}
+	free(pDecoded->pMemory);
+	memset(pDecoded, 0, sizeof(DecodedFile));
+}
+
+//----------------------------------------------------------------------------
+// a file of the cache directory
+typedef struct _CacheFileEntry {
+	char szName[MAX_PATH];
+	unsigned long long size;
+	unsigned long long lastUse;
+} CacheFileEntry;
+
+//----------------------------------------------------------------------------
+/*! qsort comparison: least recently used first
+*/
+static int CompareCacheFileEntries(const void* pLeft, const void* pRight) {
+	unsigned long long left = ((const CacheFileEntry*)pLeft)->lastUse;
+	unsigned long long right = ((const CacheFileEntry*)pRight)->lastUse;
+	return (left < right) ? -1 : ((left > right) ? 1 : 0);
+}
+
+//----------------------------------------------------------------------------
+void EvictDecodeCache(DecodeCache* pCache) {
+	char szPath[MAX_PATH];
+	sprintf_s(szPath, MAX_PATH, "%s\\*", pCache->szDirectory);
+
+	WIN32_FIND_DATA findData;
+	HANDLE hFind = FindFirstFile(szPath, &findData);
+	if (hFind == INVALID_HANDLE_VALUE) {
+		return;
+	}
+
+	FILETIME now;
+	GetSystemTimeAsFileTime(&now);
+	unsigned long long staleTime = (((unsigned long long)now.dwHighDateTime << 32) | now.dwLowDateTime) - DECODE_CACHE_STALE_TEMP_AGE;
+
+	CacheFileEntry* pEntries = NULL;
+	int entryCount = 0;
+	int entryCapacity = 0;
+	unsigned long long totalSize = 0;
+	do {
+		if ((findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == FILE_ATTRIBUTE_DIRECTORY) {
+			continue;
+		}
+		unsigned long long size = ((unsigned long long)findData.nFileSizeHigh << 32) | findData.nFileSizeLow;
+		unsigned long long lastUse = ((unsigned long long)findData.ftLastWriteTime.dwHighDateTime << 32)
+			| findData.ftLastWriteTime.dwLowDateTime;
+		size_t nameLength = strlen(findData.cFileName);
+		// not a cache file, and its path may not fit
+		if (nameLength >= DECODE_CACHE_MAX_NAME_LENGTH) {
+			continue;
+		}
+
+		// temporary file: only removed when left over by a crashed run
+		if (nameLength > 4 && strcmp(findData.cFileName + nameLength - 4, ".tmp") == 0) {
+			if (lastUse < staleTime) {
+				sprintf_s(szPath, MAX_PATH, "%s\\%s", pCache->szDirectory, findData.cFileName);
+				DeleteFile(szPath);
+			}
+			continue;
+		}
+
+		if (entryCount == entryCapacity) {
+			int capacity = (entryCapacity == 0) ? 256 : entryCapacity * 2;
+			CacheFileEntry* pGrown = (CacheFileEntry*)realloc(pEntries, capacity * sizeof(CacheFileEntry));
+			if (pGrown == NULL) {
+				break;
+			}
+			pEntries = pGrown;
+			entryCapacity = capacity;
+		}
+		CacheFileEntry* pEntry = &pEntries[entryCount++];
+		strcpy_s(pEntry->szName, MAX_PATH, findData.cFileName);
+		pEntry->size = size;
+		pEntry->lastUse = lastUse;
+		totalSize += size;
+	} while (FindNextFile(hFind, &findData));
+	FindClose(hFind);
+
+	if (totalSize > pCache->maxSize) {
+		qsort(pEntries, entryCount, sizeof(CacheFileEntry), CompareCacheFileEntries);
+		for (int i = 0; i < entryCount && totalSize > pCache->maxSize; i++) {
+			sprintf_s(szPath, MAX_PATH, "%s\\%s", pCache->szDirectory, pEntries[i].szName);
+			if (DeleteFile(szPath)) {
+				totalSize -= pEntries[i].size;
+			}
+		}
+	}
+	free(pEntries);
+}
@@ -0,0 +1,89 @@
+//This file is part of XpanderSinglePatchViewer
+
+//XpanderSinglePatchViewer is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//XpanderSinglePatchViewer is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with XpanderSinglePatchViewer.
+//If not, see <http://www.gnu.org/licenses/>.
+
+//============================================================================
+// Persistent decode cache: for each sysex file content hash, the decoded
+// single patches (offsets, program numbers and SinglePatch records) are
+// stored in a cache directory, in a format that is mapped in memory as is
+// by later runs, skipping scanning and repacking.
+// - <content hash>.xdc files hold the decoded patches
+// - <path hash>.idx files remember the content hash of a file for its size
+//   and last write time, so that unchanged files are not even read
+// Files are written to a temporary file then renamed (crash-safe), and the
+// least recently used ones are deleted when the directory exceeds its size.
+//============================================================================
+
+#ifndef _XPANDERDECODECACHE__
+#define _XPANDERDECODECACHE__
+
+#include <windows.h>
+
+#include "XpanderSysEx.h"
+
+// default size limit of the cache directory
+static const unsigned long long DECODE_CACHE_DEFAULT_MAX_SIZE = 1024ULL * 1024 * 1024;
+
+typedef struct _DecodeCache {
+	char szDirectory[MAX_PATH];
+	unsigned long long maxSize;		// bytes
+} DecodeCache;
+
+// decoded single patches of a file, mapped from the cache or in memory
+typedef struct _DecodedFile {
+	int patchCount;
+	const unsigned long long* pOffsets;		// offset of each message in the file
+	const unsigned char* pProgramNumbers;	// program number of each message
+	const SinglePatch* pPatches;			// repacked patches
+	// storage
+	HANDLE hMapping;
+	const void* pView;
+	void* pMemory;
+} DecodedFile;
+
+//----------------------------------------------------------------------------
+/*! Initialize a decode cache
+@param [out] pCache: the cache to initialize
+@param [in] pszDirectory: the cache directory, created if needed
+@param [in] maxSize: size limit of the cache directory in bytes
+@return false if the directory can not be used
+*/
+bool InitDecodeCache(DecodeCache* pCache, const char* pszDirectory, unsigned long long maxSize);
+
+//----------------------------------------------------------------------------
+/*! Get the single patches of a file, from the cache if possible, else by
+decoding the file and storing the result into the cache.
+@param [in] pCache: the cache
+@param [in] pszFileName: the sysex file
+@param [out] pDecoded: the decoded patches, to release with ReleaseDecodedFile()
+@param [out] pbCacheHit: true if the patches were mapped from the cache
+@return false if the file can not be read
+*/
+bool DecodeFileCached(DecodeCache* pCache, const char* pszFileName, DecodedFile* pDecoded, bool* pbCacheHit);
+
+//----------------------------------------------------------------------------
+/*! Release the decoded patches of a file
+@param [in] pDecoded: the decoded patches
+*/
+void ReleaseDecodedFile(DecodedFile* pDecoded);
+
+//----------------------------------------------------------------------------
+/*! Delete the least recently used cache files until the cache directory
+fits its size limit
+@param [in] pCache: the cache
+*/
+void EvictDecodeCache(DecodeCache* pCache);
+
+#endif // _XPANDERDECODECACHE__
@@ -0,0 +1,150 @@
+//This file is part of XpanderSinglePatchViewer
+
+//XpanderSinglePatchViewer is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//XpanderSinglePatchViewer is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with XpanderSinglePatchViewer.
+//If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+//stdlib
+#include <stdlib.h>
+#include <string.h>
+
+#include "XpanderDecodeContext.h"
+#include "XpanderSinglePatch.h"
+
+// every arena allocation is aligned on this
+static const size_t ARENA_ALIGNMENT = 8;
+
+//----------------------------------------------------------------------------
+bool ArenaInit(Arena* pArena, size_t capacity) {
+	pArena->pBase = (unsigned char*)malloc(capacity);
+	pArena->capacity = (pArena->pBase != NULL) ? capacity : 0;
+	pArena->used = 0;
+	return (pArena->pBase != NULL);
+}
+
+//----------------------------------------------------------------------------
+void ArenaRelease(Arena* pArena) {
+	free(pArena->pBase);
+	pArena->pBase = NULL;
+	pArena->capacity = 0;
+	pArena->used = 0;
+}
+
+//----------------------------------------------------------------------------
+void* ArenaAlloc(Arena* pArena, size_t size) {
+	size_t start = (pArena->used + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+	if (start > pArena->capacity || size > pArena->capacity - start) {
+		return NULL;
+	}
+	pArena->used = start + size;
+	return pArena->pBase + start;
+}
+
+//----------------------------------------------------------------------------
+void ArenaRewind(Arena* pArena, size_t mark) {
+	if (mark < pArena->used) {
+		pArena->used = mark;
+	}
+}
+
+//----------------------------------------------------------------------------
+bool DecodeContextInit(DecodeContext* pContext, int maxPatches, size_t textCapacity) {
+	memset(pContext, 0, sizeof(DecodeContext));
+
+	size_t tableSize = maxPatches * sizeof(DecodedPatch);
+	if (!ArenaInit(&pContext->arena, tableSize + ARENA_ALIGNMENT + textCapacity)) {
+		return false;
+	}
+	pContext->pPatches = (DecodedPatch*)ArenaAlloc(&pContext->arena, tableSize);
+	pContext->maxPatches = maxPatches;
+	pContext->patchCount = 0;
+	pContext->resetMark = pContext->arena.used;
+	return true;
+}
+
+//----------------------------------------------------------------------------
+void DecodeContextRelease(DecodeContext* pContext) {
+	ArenaRelease(&pContext->arena);
+	memset(pContext, 0, sizeof(DecodeContext));
+}
+
+//----------------------------------------------------------------------------
+void DecodeContextReset(DecodeContext* pContext) {
+	ArenaRewind(&pContext->arena, pContext->resetMark);
+	pContext->patchCount = 0;
+}
+
+//----------------------------------------------------------------------------
+/*! Format the dump of a patch in the remaining arena space
+@return the zero terminated dump, NULL if it did not fit
+*/
+static const char* FormatPatchInArena(Arena* pArena, const unsigned char* pIntro, const SinglePatch* pPatch) {
+	size_t start = pArena->used;
+	size_t available = pArena->capacity - start;
+
+	OutputSink sink;
+	InitBufferSink(&sink, (char*)pArena->pBase + start, available);
+	DumpPatchHeader(pIntro, &sink);
+	DumpPatch(pPatch, &sink);
+	if (sink.bTruncated) {
+		return NULL;
+	}
+	// keep the terminating zero
+	pArena->used = start + sink.bufferUsed + 1;
+	return (const char*)pArena->pBase + start;
+}
+
+//----------------------------------------------------------------------------
+size_t DecodeBatch(DecodeContext* pContext, const unsigned char* pData, size_t size, size_t from, int flags) {
+	size_t offset = FindSinglePatchData(pData, size, from);
+
+	while (offset < size) {
+		if (pContext->patchCount == pContext->maxPatches) {
+			return offset;
+		}
+		// nothing is committed until the whole patch fits
+		size_t mark = pContext->arena.used;
+		DecodedPatch* pDecoded = &pContext->pPatches[pContext->patchCount];
+		const unsigned char* pIntro = pData + offset;
+
+		pDecoded->offset = offset;
+		pDecoded->programNumber = pIntro[5];
+		RepackSinglePatchData(pIntro + PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH, &pDecoded->patch);
+
+		// name: high byte never used
+		char* pszName = (char*)ArenaAlloc(&pContext->arena, PATCHNAME_LENGTH + 1);
+		if (pszName == NULL) {
+			return offset;
+		}
+		for (int i = 0; i < PATCHNAME_LENGTH; i++) {
+			pszName[i] = (char)pDecoded->patch.name.character[i];
+		}
+		pszName[PATCHNAME_LENGTH] = '\0';
+		pDecoded->pszName = pszName;
+
+		pDecoded->pszDump = NULL;
+		if ((flags & DECODE_FLAG_DUMP) == DECODE_FLAG_DUMP) {
+			pDecoded->pszDump = FormatPatchInArena(&pContext->arena, pIntro, &pDecoded->patch);
+			if (pDecoded->pszDump == NULL) {
+				ArenaRewind(&pContext->arena, mark);
+				return offset;
+			}
+		}
+
+		pContext->patchCount++;
+		offset = FindSinglePatchData(pData, size, offset + PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH + SINGLE_PATCH_DATA_LENGTH);
+	}
+	return size;
+}
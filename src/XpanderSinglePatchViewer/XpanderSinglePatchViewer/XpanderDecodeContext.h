@@ -0,0 +1,126 @@
+//This file is part of XpanderSinglePatchViewer
+
+//XpanderSinglePatchViewer is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//XpanderSinglePatchViewer is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with XpanderSinglePatchViewer.
+//If not, see <http://www.gnu.org/licenses/>.
+
+//============================================================================
+// Reusable decode context for batch decoding of single patches.
+// All the memory (patch records, names, formatted output) is taken from a
+// bump-pointer arena allocated once by DecodeContextInit(): decoding batch
+// after batch with DecodeContextReset() in between never calls malloc/free.
+//============================================================================
+
+#ifndef _XPANDERDECODECONTEXT__
+#define _XPANDERDECODECONTEXT__
+
+#include <stddef.h>
+
+#include "XpanderSysEx.h"
+
+//----------------------------------------------------------------------------
+// Bump-pointer arena
+typedef struct _Arena {
+	unsigned char* pBase;	// single block allocated at init
+	size_t capacity;		// size of the block in bytes
+	size_t used;			// bytes handed out so far
+} Arena;
+
+//----------------------------------------------------------------------------
+/*! Allocate the arena block
+@param [out] pArena: the arena to initialize
+@param [in] capacity: size of the block in bytes
+@return true if the block was allocated
+*/
+bool ArenaInit(Arena* pArena, size_t capacity);
+
+//----------------------------------------------------------------------------
+/*! Free the arena block
+@param [in] pArena: the arena to release
+*/
+void ArenaRelease(Arena* pArena);
+
+//----------------------------------------------------------------------------
+/*! Take some memory from the arena
+@param [in] pArena: the arena to allocate from
+@param [in] size: number of bytes
+@return pointer aligned for any of the decoded types, NULL if the arena is full
+*/
+void* ArenaAlloc(Arena* pArena, size_t size);
+
+//----------------------------------------------------------------------------
+/*! Give back everything allocated after a mark
+@param [in] pArena: the arena to rewind
+@param [in] mark: value of pArena->used to go back to (0 to empty the arena)
+*/
+void ArenaRewind(Arena* pArena, size_t mark);
+
+//----------------------------------------------------------------------------
+// A decoded single patch. Everything pointed to lives in the context arena
+// and is valid until the next DecodeContextReset().
+typedef struct _DecodedPatch {
+	size_t offset;					// offset of the F0 byte in the batch buffer
+	unsigned char programNumber;	// program number from the intro
+	SinglePatch patch;				// repacked data
+	const char* pszName;			// patch name as an ASCII string
+	const char* pszDump;			// human-readable dump, NULL if not requested
+} DecodedPatch;
+
+// DecodeBatch() flags
+static const int DECODE_FLAG_NONE = 0x00;
+static const int DECODE_FLAG_DUMP = 0x01;	// also format the human-readable dump
+
+typedef struct _DecodeContext {
+	Arena arena;
+	DecodedPatch* pPatches;		// record table, at the beginning of the arena
+	int maxPatches;				// size of the record table
+	int patchCount;				// records decoded since last reset
+	size_t resetMark;			// arena usage just after the record table
+} DecodeContext;
+
+//----------------------------------------------------------------------------
+/*! Allocate a decode context
+@param [out] pContext: the context to initialize
+@param [in] maxPatches: maximum number of patches decoded per batch
+@param [in] textCapacity: arena bytes available per batch for names and dumps
+@return true if the memory was allocated
+*/
+bool DecodeContextInit(DecodeContext* pContext, int maxPatches, size_t textCapacity);
+
+//----------------------------------------------------------------------------
+/*! Free the memory of a decode context
+@param [in] pContext: the context to release
+*/
+void DecodeContextRelease(DecodeContext* pContext);
+
+//----------------------------------------------------------------------------
+/*! Forget the decoded patches and make the whole arena available again
+@param [in] pContext: the context to reset
+*/
+void DecodeContextReset(DecodeContext* pContext);
+
+//----------------------------------------------------------------------------
+/*! Decode all the single patches of a memory buffer into the context
+@param [in] pContext: the context to decode into
+@param [in] pData: the raw sysex buffer
+@param [in] size: size of the buffer in bytes
+@param [in] from: offset to start decoding at
+@param [in] flags: DECODE_FLAG_xxx
+@return offset to continue from in the next batch: size when the whole buffer
+was decoded, else offset of the first message that did not fit the context.
+@remark if nothing was decoded in an empty context and the returned offset is
+not size, the context is too small to hold a single patch.
+*/
+size_t DecodeBatch(DecodeContext* pContext, const unsigned char* pData, size_t size, size_t from, int flags);
+
+#endif // _XPANDERDECODECONTEXT__
@@ -0,0 +1,179 @@
+//This file is part of XpanderSinglePatchViewer
+
+//XpanderSinglePatchViewer is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//XpanderSinglePatchViewer is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with XpanderSinglePatchViewer.
+//If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+//stdlib
+#include <string.h>
+
+#include "XpanderFieldPlan.h"
+#include "XpanderPatchFields.h"
+
+//----------------------------------------------------------------------------
+/*! Match a field name against a pattern
+@param [in] pszPattern: the pattern, not null terminated
+@param [in] patternLength: length of the pattern
+@param [in] pszName: the field name
+@return true if the pattern matches the whole name, or the name up to a '.' or '['
+*/
+static bool MatchFieldPattern(const char* pszPattern, size_t patternLength, const char* pszName) {
+	while (patternLength > 0) {
+		if (*pszPattern == '*') {
+			// shortest match first, '*' never spans a '.'
+			for (const char* pszRest = pszName;; pszRest++) {
+				if (MatchFieldPattern(pszPattern + 1, patternLength - 1, pszRest)) {
+					return true;
+				}
+				if (*pszRest == '\0' || *pszRest == '.') {
+					return false;
+				}
+			}
+		}
+		if (*pszPattern != *pszName) {
+			return false;
+		}
+		pszPattern++;
+		patternLength--;
+		pszName++;
+	}
+	return *pszName == '\0' || *pszName == '.' || *pszName == '[';
+}
+
+//----------------------------------------------------------------------------
+bool CompileFieldPlan(const char* pszFields, FieldPlan* pPlan, char* pszUnknown, size_t unknownSize) {
+	memset(pPlan, 0, sizeof(FieldPlan));
+
+	bool selected[OBWORDS_DATA_LENGTH];
+	memset(selected, 0, sizeof(selected));
+	while (*pszFields != '\0') {
+		const char* pszEnd = strchr(pszFields, ',');
+		size_t length = (pszEnd != NULL) ? (size_t)(pszEnd - pszFields) : strlen(pszFields);
+		if (length > 0) {
+			bool bMatched = false;
+			if (MatchFieldPattern(pszFields, length, FIELD_PLAN_NAME_FIELD)) {
+				pPlan->bName = true;
+				bMatched = true;
+			}
+			for (int i = 0; i < OBWORDS_DATA_LENGTH; i++) {
+				if (MatchFieldPattern(pszFields, length, PatchFields[i].pszName)) {
+					selected[i] = true;
+					bMatched = true;
+				}
+			}
+			if (!bMatched) {
+				if (unknownSize > 0) {
+					size_t copyLength = (length < unknownSize - 1) ? length : unknownSize - 1;
+					memcpy(pszUnknown, pszFields, copyLength);
+					pszUnknown[copyLength] = '\0';
+				}
+				return false;
+			}
+		}
+		pszFields += length;
+		if (*pszFields == ',') {
+			pszFields++;
+		}
+	}
+
+	// offsets in the SinglePatch order, and runs of consecutive offsets
+	for (int i = 0; i < OBWORDS_DATA_LENGTH; i++) {
+		if (!selected[i]) {
+			continue;
+		}
+		pPlan->fields[pPlan->fieldCount++] = (unsigned char)i;
+		if (pPlan->rangeCount > 0) {
+			FieldPlanRange* pLast = &pPlan->ranges[pPlan->rangeCount - 1];
+			if (pLast->offset + pLast->count == i) {
+				pLast->count++;
+				continue;
+			}
+		}
+		pPlan->ranges[pPlan->rangeCount].offset = i;
+		pPlan->ranges[pPlan->rangeCount].count = 1;
+		pPlan->rangeCount++;
+	}
+	return true;
+}
+
+//----------------------------------------------------------------------------
+void RepackPlannedFields(const FieldPlan* pPlan, const unsigned char* pData, SinglePatch* pPatch) {
+	// same repacking as RepackSinglePatchData(), range by range
+	unsigned char* pBytes = (unsigned char*)pPatch;
+	for (int i = 0; i < pPlan->rangeCount; i++) {
+		const unsigned char* pWord = pData + pPlan->ranges[i].offset * 2;
+		unsigned char* pByte = pBytes + pPlan->ranges[i].offset;
+		for (int j = 0; j < pPlan->ranges[i].count; j++) {
+			*pByte = ((pWord[1] & 0x01) << 7) | pWord[0];
+			pByte++;
+			pWord += 2;
+		}
+	}
+
+	if (pPlan->bName) {
+		const unsigned char* pName = pData + OBWORDS_DATA_LENGTH * 2;
+		for (int i = 0; i < PATCHNAME_LENGTH; i++) {
+			pPatch->name.character[i] = (wchar_t)(pName[0] | (pName[1] << 8));
+			pName += 2;
+		}
+		pPatch->name.character[PATCHNAME_LENGTH] = L'\0';
+	}
+}
+
+//----------------------------------------------------------------------------
+void DumpPlannedFields(const FieldPlan* pPlan, const SinglePatch* pPatch, OutputSink* pSink) {
+	if (pPlan->bName) {
+		SinkPrintf(pSink, "NAME:\t%S\n", &pPatch->name);
+	}
+
+	const unsigned char* pBytes = (const unsigned char*)pPatch;
+	for (int i = 0; i < pPlan->fieldCount; i++) {
+		const PatchField* pField = &PatchFields[pPlan->fields[i]];
+		unsigned char value = pBytes[pPlan->fields[i]];
+		int number = (pField->kind == PATCHFIELD_SIGNED) ? (int)(signed char)value : value;
+		SinkPrintf(pSink, "%s:\t %02Xh\t %4d", pField->pszName, value, number);
+
+		switch (pField->kind) {
+		case PATCHFIELD_ENUM:
+			SinkPrintf(pSink, " : %s", (value < pField->count) ? pField->ppszValueNames[value] : "OUT OF RANGE");
+			break;
+		case PATCHFIELD_MOD_SOURCE:
+		case PATCHFIELD_MOD_DEST:
+			// unused entries are garbage
+			SinkPrintf(pSink, " : %s", (value < pField->count) ? pField->ppszValueNames[value] : "UNUSED");
+			break;
+		case PATCHFIELD_FLAGS:
+			SinkPrintf(pSink, " :");
+			for (int j = 0; j < pField->count; j++) {
+				if ((pField->pFlags[j].iNumber & value) == pField->pFlags[j].iNumber) {
+					SinkPrintf(pSink, " %s", pField->pFlags[j].pszString);
+				}
+			}
+			break;
+		case PATCHFIELD_MOD_AMOUNT:
+			{
+				int amount = value & MODULATION_VALUE_MASK;
+				if ((value & MODULATION_SIGN_MASK) == MODULATION_SIGN_MASK) {
+					amount *= -1;
+				}
+				SinkPrintf(pSink, " : amount:%d%s", amount, ((value & MODULATION_QTZ_MASK) == MODULATION_QTZ_MASK) ? " [Q]" : "");
+			}
+			break;
+		default:
+			break;
+		}
+		SinkPrintf(pSink, "\n");
+	}
+}
@@ -0,0 +1,77 @@
+//This file is part of XpanderSinglePatchViewer
+
+//XpanderSinglePatchViewer is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//XpanderSinglePatchViewer is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with XpanderSinglePatchViewer.
+//If not, see <http://www.gnu.org/licenses/>.
+
+//============================================================================
+// Field projection: a list of field patterns (e.g. "name,vcf.*,mod[*]") is
+// compiled once into a plan, then only the selected bytes of each single
+// patch message are repacked and formatted.
+//============================================================================
+
+#ifndef _XPANDERFIELDPLAN__
+#define _XPANDERFIELDPLAN__
+
+#include "XpanderSysEx.h"
+#include "XpanderOutputSink.h"
+
+// pseudo field name for the patch name, which is not part of PatchFields
+static const char* FIELD_PLAN_NAME_FIELD = "name";
+
+// consecutive selected bytes, repacked in a single loop
+typedef struct _FieldPlanRange {
+	int offset;		// first SinglePatch byte
+	int count;		// number of bytes
+} FieldPlanRange;
+
+typedef struct _FieldPlan {
+	bool bName;										// name selected
+	int fieldCount;									// number of selected fields
+	unsigned char fields[OBWORDS_DATA_LENGTH];		// offsets of the selected fields, ascending
+	int rangeCount;									// number of ranges
+	FieldPlanRange ranges[OBWORDS_DATA_LENGTH];		// selected bytes
+} FieldPlan;
+
+//----------------------------------------------------------------------------
+/*! Compile a comma separated list of field patterns.
+A pattern selects the fields whose name matches it entirely, or up to a '.'
+or '[' of the name; '*' matches any characters but '.'.
+e.g. "vcf.*": all the VCF fields, "mod[*]" or "mod": all the modulation
+entries, "*.wave": the VCOs and LFOs waves, "*": everything.
+@param [in] pszFields: the patterns
+@param [out] pPlan: the plan
+@param [out] pszUnknown: the first pattern matching no field, on error
+@param [in] unknownSize: size of pszUnknown
+@return false if a pattern matches no field
+*/
+bool CompileFieldPlan(const char* pszFields, FieldPlan* pPlan, char* pszUnknown, size_t unknownSize);
+
+//----------------------------------------------------------------------------
+/*! Repack the selected fields only, reading only their double bytes
+@param [in] pPlan: the plan
+@param [in] pData: the single patch data following the intro
+@param [out] pPatch: the patch, unselected fields are left untouched
+*/
+void RepackPlannedFields(const FieldPlan* pPlan, const unsigned char* pData, SinglePatch* pPatch);
+
+//----------------------------------------------------------------------------
+/*! Write the selected fields, one per line: name, hex and decimal values,
+then the code name, flags names or modulation amount
+@param [in] pPlan: the plan
+@param [in] pPatch: the patch repacked with RepackPlannedFields()
+@param [in] pSink: where to write to
+*/
+void DumpPlannedFields(const FieldPlan* pPlan, const SinglePatch* pPatch, OutputSink* pSink);
+
+#endif // _XPANDERFIELDPLAN__
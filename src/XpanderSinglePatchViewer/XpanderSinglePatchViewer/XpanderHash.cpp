@@ -0,0 +1,31 @@
+//This file is part of XpanderSinglePatchViewer
+
+//XpanderSinglePatchViewer is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//XpanderSinglePatchViewer is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with XpanderSinglePatchViewer.
+//If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include "XpanderHash.h"
+
+static const unsigned long long HASH_PRIME = 0x100000001B3ULL;
+
+//----------------------------------------------------------------------------
+unsigned long long HashBytes(unsigned long long hash, const void* pData, size_t size) {
+	const unsigned char* pByte = (const unsigned char*)pData;
+	for (size_t i = 0; i < size; i++) {
+		hash ^= pByte[i];
+		hash *= HASH_PRIME;
+	}
+	return hash;
+}
@@ -0,0 +1,39 @@
+//This file is part of XpanderSinglePatchViewer
+
+//XpanderSinglePatchViewer is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//XpanderSinglePatchViewer is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with XpanderSinglePatchViewer.
+//If not, see <http://www.gnu.org/licenses/>.
+
+//============================================================================
+// Content hash (64 bits FNV-1a) used to identify sysex files. The hash can
+// be computed in several steps, e.g. when data are appended to a file.
+//============================================================================
+
+#ifndef _XPANDERHASH__
+#define _XPANDERHASH__
+
+#include <stddef.h>
+
+// hash of an empty content, start value of HashBytes()
+static const unsigned long long HASH_SEED = 0xCBF29CE484222325ULL;
+
+//----------------------------------------------------------------------------
+/*! Continue a content hash with some bytes
+@param [in] hash: hash of the previous bytes, HASH_SEED for the first ones
+@param [in] pData: the next bytes
+@param [in] size: number of bytes
+@return hash of the previous bytes followed by these ones
+*/
+unsigned long long HashBytes(unsigned long long hash, const void* pData, size_t size);
+
+#endif // _XPANDERHASH__
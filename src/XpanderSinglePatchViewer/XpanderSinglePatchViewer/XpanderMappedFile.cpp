@@ -0,0 +1,69 @@
+//This file is part of XpanderSinglePatchViewer
+
+//XpanderSinglePatchViewer is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//XpanderSinglePatchViewer is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with XpanderSinglePatchViewer.
+//If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+//stdlib
+#include <string.h>
+
+#include "XpanderMappedFile.h"
+
+//----------------------------------------------------------------------------
+bool MapInputFile(const char* pszFileName, MappedFile* pMapped) {
+	memset(pMapped, 0, sizeof(MappedFile));
+
+	HANDLE hFile = CreateFile(pszFileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (hFile == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(hFile, &fileSize)) {
+		CloseHandle(hFile);
+		return false;
+	}
+	// nothing to map
+	if (fileSize.QuadPart == 0) {
+		CloseHandle(hFile);
+		return true;
+	}
+
+	HANDLE hMapping = CreateFileMapping(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(hFile);
+	if (hMapping == NULL) {
+		return false;
+	}
+	const void* pView = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+	if (pView == NULL) {
+		CloseHandle(hMapping);
+		return false;
+	}
+	pMapped->hMapping = hMapping;
+	pMapped->pData = (const unsigned char*)pView;
+	pMapped->size = (size_t)fileSize.QuadPart;
+	return true;
+}
+
+//----------------------------------------------------------------------------
+void UnmapInputFile(MappedFile* pMapped) {
+	if (pMapped->pData != NULL) {
+		UnmapViewOfFile(pMapped->pData);
+	}
+	if (pMapped->hMapping != NULL) {
+		CloseHandle(pMapped->hMapping);
+	}
+	memset(pMapped, 0, sizeof(MappedFile));
+}
@@ -0,0 +1,46 @@
+//This file is part of XpanderSinglePatchViewer
+
+//XpanderSinglePatchViewer is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//XpanderSinglePatchViewer is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with XpanderSinglePatchViewer.
+//If not, see <http://www.gnu.org/licenses/>.
+
+//============================================================================
+// Read-only memory mapped input file
+//============================================================================
+
+#ifndef _XPANDERMAPPEDFILE__
+#define _XPANDERMAPPEDFILE__
+
+#include <windows.h>
+
+typedef struct _MappedFile {
+	HANDLE hMapping;			// NULL for an empty file
+	const unsigned char* pData;	// the file content, NULL for an empty file
+	size_t size;				// size of the file in bytes
+} MappedFile;
+
+//----------------------------------------------------------------------------
+/*! Map a whole file in memory
+@param [in] pszFileName: the file to map
+@param [out] pMapped: the mapped file
+@return false if the file can not be opened or mapped
+*/
+bool MapInputFile(const char* pszFileName, MappedFile* pMapped);
+
+//----------------------------------------------------------------------------
+/*! Unmap a file mapped by MapInputFile()
+@param [in] pMapped: the mapped file
+*/
+void UnmapInputFile(MappedFile* pMapped);
+
+#endif // _XPANDERMAPPEDFILE__
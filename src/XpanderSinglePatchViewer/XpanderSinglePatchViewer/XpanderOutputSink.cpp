@@ -0,0 +1,67 @@
+//This file is part of XpanderSinglePatchViewer
+
+//XpanderSinglePatchViewer is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//XpanderSinglePatchViewer is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with XpanderSinglePatchViewer.
+//If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+//stdlib
+#include <stdarg.h>
+
+#include "XpanderOutputSink.h"
+
+//----------------------------------------------------------------------------
+void InitFileSink(OutputSink* pSink, FILE* pFile) {
+	pSink->pFile = pFile;
+	pSink->pBuffer = NULL;
+	pSink->bufferSize = 0;
+	pSink->bufferUsed = 0;
+	pSink->bTruncated = false;
+}
+
+//----------------------------------------------------------------------------
+void InitBufferSink(OutputSink* pSink, char* pBuffer, size_t bufferSize) {
+	pSink->pFile = NULL;
+	pSink->pBuffer = pBuffer;
+	pSink->bufferSize = bufferSize;
+	pSink->bufferUsed = 0;
+	pSink->bTruncated = (bufferSize == 0);
+	if (bufferSize > 0) {
+		pBuffer[0] = '\0';
+	}
+}
+
+//----------------------------------------------------------------------------
+void SinkPrintf(OutputSink* pSink, const char* pszFormat, ...) {
+	va_list args;
+	va_start(args, pszFormat);
+
+	if (pSink->pFile != NULL) {
+		vfprintf(pSink->pFile, pszFormat, args);
+	}
+	else if (!pSink->bTruncated) {
+		size_t available = pSink->bufferSize - pSink->bufferUsed;
+		int iWritten = vsnprintf(pSink->pBuffer + pSink->bufferUsed, available, pszFormat, args);
+		if (iWritten < 0 || (size_t)iWritten >= available) {
+			// keep what was written before this call, zero terminated
+			pSink->pBuffer[pSink->bufferUsed] = '\0';
+			pSink->bTruncated = true;
+		}
+		else {
+			pSink->bufferUsed += iWritten;
+		}
+	}
+
+	va_end(args);
+}
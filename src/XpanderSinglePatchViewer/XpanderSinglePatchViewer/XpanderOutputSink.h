@@ -0,0 +1,57 @@
+//This file is part of XpanderSinglePatchViewer
+
+//XpanderSinglePatchViewer is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//XpanderSinglePatchViewer is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with XpanderSinglePatchViewer.
+//If not, see <http://www.gnu.org/licenses/>.
+
+//============================================================================
+// Output sink: human-readable output goes either to an opened file (stdout)
+// or to a caller supplied character buffer, with the same printf-like call.
+//============================================================================
+
+#ifndef _XPANDEROUTPUTSINK__
+#define _XPANDEROUTPUTSINK__
+
+#include <stdio.h>
+#include <stddef.h>
+
+typedef struct _OutputSink {
+	FILE* pFile;		// when not NULL, output is written to this file
+	char* pBuffer;		// else output is appended to this buffer...
+	size_t bufferSize;	// ...of this size (terminating zero included)
+	size_t bufferUsed;	// characters written so far, terminating zero excluded
+	bool bTruncated;	// true if some output did not fit in the buffer
+} OutputSink;
+
+//----------------------------------------------------------------------------
+/*! Initialize a sink writing to an opened file
+@param [out] pSink: the sink to initialize
+@param [in] pFile: the file to write to
+*/
+void InitFileSink(OutputSink* pSink, FILE* pFile);
+
+//----------------------------------------------------------------------------
+/*! Initialize a sink writing to a character buffer
+@param [out] pSink: the sink to initialize
+@param [in] pBuffer: the buffer to write to, always zero terminated
+@param [in] bufferSize: size of the buffer in bytes
+*/
+void InitBufferSink(OutputSink* pSink, char* pBuffer, size_t bufferSize);
+
+//----------------------------------------------------------------------------
+/*! printf-like output to a sink
+@remark once a buffer sink is truncated, further output is dropped.
+*/
+void SinkPrintf(OutputSink* pSink, const char* pszFormat, ...);
+
+#endif // _XPANDEROUTPUTSINK__
@@ -0,0 +1,218 @@
+//This file is part of XpanderSinglePatchViewer
+
+//XpanderSinglePatchViewer is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//XpanderSinglePatchViewer is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with XpanderSinglePatchViewer.
+//If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include "XpanderPatchFields.h"
+
+const PatchField PatchFields[OBWORDS_DATA_LENGTH] = {
+	// VCO
+	{ "vco[0].freq", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "vco[0].detune", PATCHFIELD_SIGNED, NULL, NULL, 0 },
+	{ "vco[0].pw", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "vco[0].vol", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "vco[0].mod", PATCHFIELD_FLAGS, NULL, ModulationFlagsNames, MODULATIONFLAGS_COUNT },
+	{ "vco[0].wave", PATCHFIELD_FLAGS, NULL, VCOWavesFlagsNames, VCOWAVEFLAGS_COUNT },
+	{ "vco[1].freq", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "vco[1].detune", PATCHFIELD_SIGNED, NULL, NULL, 0 },
+	{ "vco[1].pw", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "vco[1].vol", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "vco[1].mod", PATCHFIELD_FLAGS, NULL, ModulationFlagsNames, MODULATIONFLAGS_COUNT },
+	{ "vco[1].wave", PATCHFIELD_FLAGS, NULL, VCOWavesFlagsNames, VCOWAVEFLAGS_COUNT },
+	// VCF
+	{ "vcf.freq", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "vcf.res", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "vcf.fmode", PATCHFIELD_ENUM, VCFFilterTypesNames, NULL, VCFFILTERTYPES_COUNT },
+	{ "vcf.vca1", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "vcf.vca2", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "vcf.mod", PATCHFIELD_FLAGS, NULL, ModulationFlagsNames, MODULATIONFLAGS_COUNT },
+	// FM_LAG
+	{ "fm_lag.fm_amp", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "fm_lag.fm_dest", PATCHFIELD_ENUM, FMDestinationTypesNames, NULL, FMDESTINATIONTYPES_COUNT },
+	{ "fm_lag.lag_in", PATCHFIELD_ENUM, ModulationSourcesFlagsNames, NULL, MODULATIONSOURCESFLAGS_COUNT },
+	{ "fm_lag.lag_rate", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "fm_lag.lag_mode", PATCHFIELD_FLAGS, NULL, LagModeFlagsNames, LAGMODEFLAGS_COUNT },
+	// LFO
+	{ "lfo[0].speed", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "lfo[0].retrig_mode", PATCHFIELD_ENUM, TriggerTypesNames, NULL, TRIGGERTYPES_COUNT },
+	{ "lfo[0].lag", PATCHFIELD_FLAGS, NULL, LagFlagsNames, LAGFLAGS_COUNT },
+	{ "lfo[0].wave", PATCHFIELD_ENUM, WaveTypesNames, NULL, WAVETYPES_COUNT },
+	{ "lfo[0].retrig", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "lfo[0].sample", PATCHFIELD_ENUM, ModulationSourcesFlagsNames, NULL, MODULATIONSOURCESFLAGS_COUNT },
+	{ "lfo[0].amp", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "lfo[1].speed", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "lfo[1].retrig_mode", PATCHFIELD_ENUM, TriggerTypesNames, NULL, TRIGGERTYPES_COUNT },
+	{ "lfo[1].lag", PATCHFIELD_FLAGS, NULL, LagFlagsNames, LAGFLAGS_COUNT },
+	{ "lfo[1].wave", PATCHFIELD_ENUM, WaveTypesNames, NULL, WAVETYPES_COUNT },
+	{ "lfo[1].retrig", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "lfo[1].sample", PATCHFIELD_ENUM, ModulationSourcesFlagsNames, NULL, MODULATIONSOURCESFLAGS_COUNT },
+	{ "lfo[1].amp", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "lfo[2].speed", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "lfo[2].retrig_mode", PATCHFIELD_ENUM, TriggerTypesNames, NULL, TRIGGERTYPES_COUNT },
+	{ "lfo[2].lag", PATCHFIELD_FLAGS, NULL, LagFlagsNames, LAGFLAGS_COUNT },
+	{ "lfo[2].wave", PATCHFIELD_ENUM, WaveTypesNames, NULL, WAVETYPES_COUNT },
+	{ "lfo[2].retrig", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "lfo[2].sample", PATCHFIELD_ENUM, ModulationSourcesFlagsNames, NULL, MODULATIONSOURCESFLAGS_COUNT },
+	{ "lfo[2].amp", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "lfo[3].speed", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "lfo[3].retrig_mode", PATCHFIELD_ENUM, TriggerTypesNames, NULL, TRIGGERTYPES_COUNT },
+	{ "lfo[3].lag", PATCHFIELD_FLAGS, NULL, LagFlagsNames, LAGFLAGS_COUNT },
+	{ "lfo[3].wave", PATCHFIELD_ENUM, WaveTypesNames, NULL, WAVETYPES_COUNT },
+	{ "lfo[3].retrig", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "lfo[3].sample", PATCHFIELD_ENUM, ModulationSourcesFlagsNames, NULL, MODULATIONSOURCESFLAGS_COUNT },
+	{ "lfo[3].amp", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "lfo[4].speed", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "lfo[4].retrig_mode", PATCHFIELD_ENUM, TriggerTypesNames, NULL, TRIGGERTYPES_COUNT },
+	{ "lfo[4].lag", PATCHFIELD_FLAGS, NULL, LagFlagsNames, LAGFLAGS_COUNT },
+	{ "lfo[4].wave", PATCHFIELD_ENUM, WaveTypesNames, NULL, WAVETYPES_COUNT },
+	{ "lfo[4].retrig", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "lfo[4].sample", PATCHFIELD_ENUM, ModulationSourcesFlagsNames, NULL, MODULATIONSOURCESFLAGS_COUNT },
+	{ "lfo[4].amp", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	// ENV
+	{ "env[0].flags", PATCHFIELD_FLAGS, NULL, EnveloppeModeFlagsNames, ENVELOPPEMODEFLAGS_COUNT },
+	{ "env[0].lfotrig", PATCHFIELD_ENUM, LFOTriggerCodesNames, NULL, LFOTRIGGERCODES_COUNT },
+	{ "env[0].delay", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "env[0].attack", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "env[0].decay", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "env[0].sustain", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "env[0].release", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "env[0].amp", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "env[1].flags", PATCHFIELD_FLAGS, NULL, EnveloppeModeFlagsNames, ENVELOPPEMODEFLAGS_COUNT },
+	{ "env[1].lfotrig", PATCHFIELD_ENUM, LFOTriggerCodesNames, NULL, LFOTRIGGERCODES_COUNT },
+	{ "env[1].delay", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "env[1].attack", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "env[1].decay", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "env[1].sustain", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "env[1].release", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "env[1].amp", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "env[2].flags", PATCHFIELD_FLAGS, NULL, EnveloppeModeFlagsNames, ENVELOPPEMODEFLAGS_COUNT },
+	{ "env[2].lfotrig", PATCHFIELD_ENUM, LFOTriggerCodesNames, NULL, LFOTRIGGERCODES_COUNT },
+	{ "env[2].delay", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "env[2].attack", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "env[2].decay", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "env[2].sustain", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "env[2].release", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "env[2].amp", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "env[3].flags", PATCHFIELD_FLAGS, NULL, EnveloppeModeFlagsNames, ENVELOPPEMODEFLAGS_COUNT },
+	{ "env[3].lfotrig", PATCHFIELD_ENUM, LFOTriggerCodesNames, NULL, LFOTRIGGERCODES_COUNT },
+	{ "env[3].delay", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "env[3].attack", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "env[3].decay", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "env[3].sustain", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "env[3].release", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "env[3].amp", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "env[4].flags", PATCHFIELD_FLAGS, NULL, EnveloppeModeFlagsNames, ENVELOPPEMODEFLAGS_COUNT },
+	{ "env[4].lfotrig", PATCHFIELD_ENUM, LFOTriggerCodesNames, NULL, LFOTRIGGERCODES_COUNT },
+	{ "env[4].delay", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "env[4].attack", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "env[4].decay", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "env[4].sustain", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "env[4].release", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "env[4].amp", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	// TRACK
+	{ "track[0].input", PATCHFIELD_ENUM, ModulationSourcesFlagsNames, NULL, MODULATIONSOURCESFLAGS_COUNT },
+	{ "track[0].point[0]", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "track[0].point[1]", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "track[0].point[2]", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "track[0].point[3]", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "track[0].point[4]", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "track[1].input", PATCHFIELD_ENUM, ModulationSourcesFlagsNames, NULL, MODULATIONSOURCESFLAGS_COUNT },
+	{ "track[1].point[0]", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "track[1].point[1]", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "track[1].point[2]", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "track[1].point[3]", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "track[1].point[4]", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "track[2].input", PATCHFIELD_ENUM, ModulationSourcesFlagsNames, NULL, MODULATIONSOURCESFLAGS_COUNT },
+	{ "track[2].point[0]", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "track[2].point[1]", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "track[2].point[2]", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "track[2].point[3]", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "track[2].point[4]", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	// RAMP
+	{ "ramp[0].rate", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "ramp[0].flags", PATCHFIELD_FLAGS, NULL, RampFlagsNames, RAMPFLAGS_COUNT },
+	{ "ramp[0].lfotrig", PATCHFIELD_ENUM, LFOTriggerCodesNames, NULL, LFOTRIGGERCODES_COUNT },
+	{ "ramp[1].rate", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "ramp[1].flags", PATCHFIELD_FLAGS, NULL, RampFlagsNames, RAMPFLAGS_COUNT },
+	{ "ramp[1].lfotrig", PATCHFIELD_ENUM, LFOTriggerCodesNames, NULL, LFOTRIGGERCODES_COUNT },
+	{ "ramp[2].rate", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "ramp[2].flags", PATCHFIELD_FLAGS, NULL, RampFlagsNames, RAMPFLAGS_COUNT },
+	{ "ramp[2].lfotrig", PATCHFIELD_ENUM, LFOTriggerCodesNames, NULL, LFOTRIGGERCODES_COUNT },
+	{ "ramp[3].rate", PATCHFIELD_VALUE, NULL, NULL, 0 },
+	{ "ramp[3].flags", PATCHFIELD_FLAGS, NULL, RampFlagsNames, RAMPFLAGS_COUNT },
+	{ "ramp[3].lfotrig", PATCHFIELD_ENUM, LFOTriggerCodesNames, NULL, LFOTRIGGERCODES_COUNT },
+	// MOD
+	{ "mod[0].source", PATCHFIELD_MOD_SOURCE, ModulationSourcesFlagsNames, NULL, MODULATION_SOURCE_COUNT },
+	{ "mod[0].amountSignAndQuantize", PATCHFIELD_MOD_AMOUNT, NULL, NULL, 0 },
+	{ "mod[0].dest", PATCHFIELD_MOD_DEST, ModulationDestinationsTypesNames, NULL, MODULATION_DEST_COUNT },
+	{ "mod[1].source", PATCHFIELD_MOD_SOURCE, ModulationSourcesFlagsNames, NULL, MODULATION_SOURCE_COUNT },
+	{ "mod[1].amountSignAndQuantize", PATCHFIELD_MOD_AMOUNT, NULL, NULL, 0 },
+	{ "mod[1].dest", PATCHFIELD_MOD_DEST, ModulationDestinationsTypesNames, NULL, MODULATION_DEST_COUNT },
+	{ "mod[2].source", PATCHFIELD_MOD_SOURCE, ModulationSourcesFlagsNames, NULL, MODULATION_SOURCE_COUNT },
+	{ "mod[2].amountSignAndQuantize", PATCHFIELD_MOD_AMOUNT, NULL, NULL, 0 },
+	{ "mod[2].dest", PATCHFIELD_MOD_DEST, ModulationDestinationsTypesNames, NULL, MODULATION_DEST_COUNT },
+	{ "mod[3].source", PATCHFIELD_MOD_SOURCE, ModulationSourcesFlagsNames, NULL, MODULATION_SOURCE_COUNT },
+	{ "mod[3].amountSignAndQuantize", PATCHFIELD_MOD_AMOUNT, NULL, NULL, 0 },
+	{ "mod[3].dest", PATCHFIELD_MOD_DEST, ModulationDestinationsTypesNames, NULL, MODULATION_DEST_COUNT },
+	{ "mod[4].source", PATCHFIELD_MOD_SOURCE, ModulationSourcesFlagsNames, NULL, MODULATION_SOURCE_COUNT },
+	{ "mod[4].amountSignAndQuantize", PATCHFIELD_MOD_AMOUNT, NULL, NULL, 0 },
+	{ "mod[4].dest", PATCHFIELD_MOD_DEST, ModulationDestinationsTypesNames, NULL, MODULATION_DEST_COUNT },
+	{ "mod[5].source", PATCHFIELD_MOD_SOURCE, ModulationSourcesFlagsNames, NULL, MODULATION_SOURCE_COUNT },
+	{ "mod[5].amountSignAndQuantize", PATCHFIELD_MOD_AMOUNT, NULL, NULL, 0 },
+	{ "mod[5].dest", PATCHFIELD_MOD_DEST, ModulationDestinationsTypesNames, NULL, MODULATION_DEST_COUNT },
+	{ "mod[6].source", PATCHFIELD_MOD_SOURCE, ModulationSourcesFlagsNames, NULL, MODULATION_SOURCE_COUNT },
+	{ "mod[6].amountSignAndQuantize", PATCHFIELD_MOD_AMOUNT, NULL, NULL, 0 },
+	{ "mod[6].dest", PATCHFIELD_MOD_DEST, ModulationDestinationsTypesNames, NULL, MODULATION_DEST_COUNT },
+	{ "mod[7].source", PATCHFIELD_MOD_SOURCE, ModulationSourcesFlagsNames, NULL, MODULATION_SOURCE_COUNT },
+	{ "mod[7].amountSignAndQuantize", PATCHFIELD_MOD_AMOUNT, NULL, NULL, 0 },
+	{ "mod[7].dest", PATCHFIELD_MOD_DEST, ModulationDestinationsTypesNames, NULL, MODULATION_DEST_COUNT },
+	{ "mod[8].source", PATCHFIELD_MOD_SOURCE, ModulationSourcesFlagsNames, NULL, MODULATION_SOURCE_COUNT },
+	{ "mod[8].amountSignAndQuantize", PATCHFIELD_MOD_AMOUNT, NULL, NULL, 0 },
+	{ "mod[8].dest", PATCHFIELD_MOD_DEST, ModulationDestinationsTypesNames, NULL, MODULATION_DEST_COUNT },
+	{ "mod[9].source", PATCHFIELD_MOD_SOURCE, ModulationSourcesFlagsNames, NULL, MODULATION_SOURCE_COUNT },
+	{ "mod[9].amountSignAndQuantize", PATCHFIELD_MOD_AMOUNT, NULL, NULL, 0 },
+	{ "mod[9].dest", PATCHFIELD_MOD_DEST, ModulationDestinationsTypesNames, NULL, MODULATION_DEST_COUNT },
+	{ "mod[10].source", PATCHFIELD_MOD_SOURCE, ModulationSourcesFlagsNames, NULL, MODULATION_SOURCE_COUNT },
+	{ "mod[10].amountSignAndQuantize", PATCHFIELD_MOD_AMOUNT, NULL, NULL, 0 },
+	{ "mod[10].dest", PATCHFIELD_MOD_DEST, ModulationDestinationsTypesNames, NULL, MODULATION_DEST_COUNT },
+	{ "mod[11].source", PATCHFIELD_MOD_SOURCE, ModulationSourcesFlagsNames, NULL, MODULATION_SOURCE_COUNT },
+	{ "mod[11].amountSignAndQuantize", PATCHFIELD_MOD_AMOUNT, NULL, NULL, 0 },
+	{ "mod[11].dest", PATCHFIELD_MOD_DEST, ModulationDestinationsTypesNames, NULL, MODULATION_DEST_COUNT },
+	{ "mod[12].source", PATCHFIELD_MOD_SOURCE, ModulationSourcesFlagsNames, NULL, MODULATION_SOURCE_COUNT },
+	{ "mod[12].amountSignAndQuantize", PATCHFIELD_MOD_AMOUNT, NULL, NULL, 0 },
+	{ "mod[12].dest", PATCHFIELD_MOD_DEST, ModulationDestinationsTypesNames, NULL, MODULATION_DEST_COUNT },
+	{ "mod[13].source", PATCHFIELD_MOD_SOURCE, ModulationSourcesFlagsNames, NULL, MODULATION_SOURCE_COUNT },
+	{ "mod[13].amountSignAndQuantize", PATCHFIELD_MOD_AMOUNT, NULL, NULL, 0 },
+	{ "mod[13].dest", PATCHFIELD_MOD_DEST, ModulationDestinationsTypesNames, NULL, MODULATION_DEST_COUNT },
+	{ "mod[14].source", PATCHFIELD_MOD_SOURCE, ModulationSourcesFlagsNames, NULL, MODULATION_SOURCE_COUNT },
+	{ "mod[14].amountSignAndQuantize", PATCHFIELD_MOD_AMOUNT, NULL, NULL, 0 },
+	{ "mod[14].dest", PATCHFIELD_MOD_DEST, ModulationDestinationsTypesNames, NULL, MODULATION_DEST_COUNT },
+	{ "mod[15].source", PATCHFIELD_MOD_SOURCE, ModulationSourcesFlagsNames, NULL, MODULATION_SOURCE_COUNT },
+	{ "mod[15].amountSignAndQuantize", PATCHFIELD_MOD_AMOUNT, NULL, NULL, 0 },
+	{ "mod[15].dest", PATCHFIELD_MOD_DEST, ModulationDestinationsTypesNames, NULL, MODULATION_DEST_COUNT },
+	{ "mod[16].source", PATCHFIELD_MOD_SOURCE, ModulationSourcesFlagsNames, NULL, MODULATION_SOURCE_COUNT },
+	{ "mod[16].amountSignAndQuantize", PATCHFIELD_MOD_AMOUNT, NULL, NULL, 0 },
+	{ "mod[16].dest", PATCHFIELD_MOD_DEST, ModulationDestinationsTypesNames, NULL, MODULATION_DEST_COUNT },
+	{ "mod[17].source", PATCHFIELD_MOD_SOURCE, ModulationSourcesFlagsNames, NULL, MODULATION_SOURCE_COUNT },
+	{ "mod[17].amountSignAndQuantize", PATCHFIELD_MOD_AMOUNT, NULL, NULL, 0 },
+	{ "mod[17].dest", PATCHFIELD_MOD_DEST, ModulationDestinationsTypesNames, NULL, MODULATION_DEST_COUNT },
+	{ "mod[18].source", PATCHFIELD_MOD_SOURCE, ModulationSourcesFlagsNames, NULL, MODULATION_SOURCE_COUNT },
+	{ "mod[18].amountSignAndQuantize", PATCHFIELD_MOD_AMOUNT, NULL, NULL, 0 },
+	{ "mod[18].dest", PATCHFIELD_MOD_DEST, ModulationDestinationsTypesNames, NULL, MODULATION_DEST_COUNT },
+	{ "mod[19].source", PATCHFIELD_MOD_SOURCE, ModulationSourcesFlagsNames, NULL, MODULATION_SOURCE_COUNT },
+	{ "mod[19].amountSignAndQuantize", PATCHFIELD_MOD_AMOUNT, NULL, NULL, 0 },
+	{ "mod[19].dest", PATCHFIELD_MOD_DEST, ModulationDestinationsTypesNames, NULL, MODULATION_DEST_COUNT }
+};
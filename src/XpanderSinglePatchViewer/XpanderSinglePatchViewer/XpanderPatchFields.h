@@ -0,0 +1,49 @@
+//This file is part of XpanderSinglePatchViewer
+
+//XpanderSinglePatchViewer is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//XpanderSinglePatchViewer is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with XpanderSinglePatchViewer.
+//If not, see <http://www.gnu.org/licenses/>.
+
+//============================================================================
+// Description of the SinglePatch fields: name and kind of each of the 188
+// bytes, with the value names of the enums and flags from XpanderSysEx.h
+//============================================================================
+
+#ifndef _XPANDERPATCHFIELDS__
+#define _XPANDERPATCHFIELDS__
+
+#include "XpanderSysEx.h"
+
+// PatchFieldKinds
+typedef enum _PatchFieldKinds {
+	PATCHFIELD_VALUE,		// unsigned value
+	PATCHFIELD_SIGNED,		// signed value
+	PATCHFIELD_ENUM,		// code, see ppszValueNames
+	PATCHFIELD_FLAGS,		// bitfield, see pFlags
+	PATCHFIELD_MOD_SOURCE,	// modulation source code, out of range for an unused entry
+	PATCHFIELD_MOD_AMOUNT,	// modulation amount, sign and quantize
+	PATCHFIELD_MOD_DEST		// modulation destination code, out of range for an unused entry
+} PatchFieldKinds;
+
+typedef struct _PatchField {
+	const char* pszName;				// e.g. "lfo[2].wave"
+	PatchFieldKinds kind;
+	const char* const* ppszValueNames;	// PATCHFIELD_ENUM and PATCHFIELD_MOD_xxx codes names, NULL otherwise
+	const NumberStringPair* pFlags;		// PATCHFIELD_FLAGS names, NULL otherwise
+	int count;							// number of codes or flags names
+} PatchField;
+
+// one entry per SinglePatch byte, indexed by offset
+extern const PatchField PatchFields[OBWORDS_DATA_LENGTH];
+
+#endif // _XPANDERPATCHFIELDS__
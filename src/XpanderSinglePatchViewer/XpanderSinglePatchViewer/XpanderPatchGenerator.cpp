@@ -0,0 +1,334 @@
+//This file is part of XpanderSinglePatchViewer
+
+//XpanderSinglePatchViewer is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//XpanderSinglePatchViewer is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with XpanderSinglePatchViewer.
+//If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+//stdlib
+#include <stdlib.h>
+#include <string.h>
+
+#include "XpanderPatchGenerator.h"
+
+// most of the parameters are 6 bits values
+static const int PARAMETER_MAX_VALUE = 63;
+// except the filter frequency
+static const int VCF_FREQ_MAX_VALUE = 127;
+// detune is signed
+static const int DETUNE_MAX_VALUE = 31;
+
+// default rates
+static const double DEFAULT_MUTATION_RATE = 0.05;
+static const double DEFAULT_CROSSOVER_RATE = 0.5;
+
+// random values used per generated patch: one per field, then the parents
+// choice, the crossover decision and 64 bits of section choice, rounded
+// up to a multiple of the PRNG lanes
+static const int RANDOM_PARENT_A = OBWORDS_DATA_LENGTH;
+static const int RANDOM_PARENT_B = OBWORDS_DATA_LENGTH + 1;
+static const int RANDOM_CROSSOVER = OBWORDS_DATA_LENGTH + 2;
+static const int RANDOM_SECTIONS_LOW = OBWORDS_DATA_LENGTH + 3;
+static const int RANDOM_SECTIONS_HIGH = OBWORDS_DATA_LENGTH + 4;
+static const int RANDOM_VALUES_PER_PATCH = ((OBWORDS_DATA_LENGTH + 5 + PATCH_RNG_LANES - 1) / PATCH_RNG_LANES) * PATCH_RNG_LANES;
+
+//----------------------------------------------------------------------------
+void SeedPatchRng(PatchRng* pRng, unsigned int seed) {
+	// one different non-zero state per lane
+	for (int lane = 0; lane < PATCH_RNG_LANES; lane++) {
+		unsigned int x = seed + 0x9E3779B9 * (lane + 1);
+		x = (x ^ (x >> 16)) * 0x85EBCA6B;
+		x = (x ^ (x >> 13)) * 0xC2B2AE35;
+		x ^= x >> 16;
+		pRng->state[lane] = (x != 0) ? x : 0x6C078965;
+	}
+}
+
+//----------------------------------------------------------------------------
+void FillPatchRng(PatchRng* pRng, unsigned int* pValues, int count) {
+	int i = 0;
+	for (; i + PATCH_RNG_LANES <= count; i += PATCH_RNG_LANES) {
+		// independent lanes: vectorizable
+		for (int lane = 0; lane < PATCH_RNG_LANES; lane++) {
+			unsigned int x = pRng->state[lane];
+			x ^= x << 13;
+			x ^= x >> 17;
+			x ^= x << 5;
+			pRng->state[lane] = x;
+			pValues[i + lane] = x;
+		}
+	}
+	if (i < count) {
+		unsigned int tail[PATCH_RNG_LANES];
+		FillPatchRng(pRng, tail, PATCH_RNG_LANES);
+		memcpy(pValues + i, tail, (count - i) * sizeof(unsigned int));
+	}
+}
+
+//----------------------------------------------------------------------------
+/*! All the flags of a NumberStringPair table
+*/
+static unsigned char GetFlagsMask(const NumberStringPair* pFlags, int count) {
+	unsigned char mask = 0;
+	for (int i = 0; i < count; i++) {
+		mask |= pFlags[i].iNumber;
+	}
+	return mask;
+}
+
+//----------------------------------------------------------------------------
+/*! Set the constraint of a field and its new value tables
+*/
+static void SetFieldConstraint(PatchGenerator* pGenerator, size_t offset, FieldConstraintKinds kind, int maxValue) {
+	pGenerator->constraints[offset].kind = (unsigned char)kind;
+	pGenerator->constraints[offset].maxValue = (unsigned char)maxValue;
+
+	switch (kind) {
+	case FIELD_RANGE:
+	case FIELD_MOD_ROUTING:
+		pGenerator->valueCounts[offset] = maxValue + 1;
+		pGenerator->valueBases[offset] = 0;
+		pGenerator->valueMasks[offset] = 0xFF;
+		break;
+	case FIELD_SIGNED_RANGE:
+		pGenerator->valueCounts[offset] = 2 * maxValue + 1;
+		pGenerator->valueBases[offset] = (unsigned char)(-maxValue);
+		pGenerator->valueMasks[offset] = 0xFF;
+		break;
+	case FIELD_FLAGS:
+		pGenerator->valueCounts[offset] = 256;
+		pGenerator->valueBases[offset] = 0;
+		pGenerator->valueMasks[offset] = (unsigned char)maxValue;
+		break;
+	default:
+		pGenerator->valueCounts[offset] = 256;
+		pGenerator->valueBases[offset] = 0;
+		pGenerator->valueMasks[offset] = 0xFF;
+		break;
+	}
+}
+
+//----------------------------------------------------------------------------
+/*! Set the crossover section of some fields
+*/
+static void SetSection(PatchGenerator* pGenerator, size_t offset, size_t size, int section) {
+	memset(pGenerator->sections + offset, section, size);
+}
+
+// offsets of the fields of the SinglePatch arrays of anonymous structs
+#define ARRAY_ELEMENT_SIZE(array) sizeof(((SinglePatch*)0)->array[0])
+#define ARRAY_ELEMENT_OFFSET(array, i) (offsetof(SinglePatch, array) + (i) * ARRAY_ELEMENT_SIZE(array))
+#define ARRAY_FIELD_OFFSET(array, i, field) (ARRAY_ELEMENT_OFFSET(array, i) + offsetof(SinglePatch, array[0].field) - offsetof(SinglePatch, array))
+
+//----------------------------------------------------------------------------
+/*! Build the constraint and section tables from XpanderSysEx.h
+*/
+static void BuildFieldTables(PatchGenerator* pGenerator) {
+	// 6 bits values by default
+	for (int i = 0; i < OBWORDS_DATA_LENGTH; i++) {
+		SetFieldConstraint(pGenerator, i, FIELD_RANGE, PARAMETER_MAX_VALUE);
+	}
+	int section = 0;
+
+	// VCO (x2)
+	for (int i = 0; i < 2; i++) {
+		SetSection(pGenerator, ARRAY_ELEMENT_OFFSET(vco, i), ARRAY_ELEMENT_SIZE(vco), section++);
+		SetFieldConstraint(pGenerator, ARRAY_FIELD_OFFSET(vco, i, detune), FIELD_SIGNED_RANGE, DETUNE_MAX_VALUE);
+		SetFieldConstraint(pGenerator, ARRAY_FIELD_OFFSET(vco, i, mod), FIELD_FLAGS, GetFlagsMask(ModulationFlagsNames, MODULATIONFLAGS_COUNT));
+		SetFieldConstraint(pGenerator, ARRAY_FIELD_OFFSET(vco, i, wave), FIELD_FLAGS, GetFlagsMask(VCOWavesFlagsNames, VCOWAVEFLAGS_COUNT));
+	}
+
+	// VCF
+	SetSection(pGenerator, offsetof(SinglePatch, vcf), sizeof(SinglePatch::vcf), section++);
+	SetFieldConstraint(pGenerator, offsetof(SinglePatch, vcf.freq), FIELD_RANGE, VCF_FREQ_MAX_VALUE);
+	SetFieldConstraint(pGenerator, offsetof(SinglePatch, vcf.fmode), FIELD_RANGE, VCFFILTERTYPES_COUNT - 1);
+	SetFieldConstraint(pGenerator, offsetof(SinglePatch, vcf.mod), FIELD_FLAGS, GetFlagsMask(ModulationFlagsNames, MODULATIONFLAGS_COUNT));
+
+	// FM LAG
+	SetSection(pGenerator, offsetof(SinglePatch, fm_lag), sizeof(SinglePatch::fm_lag), section++);
+	SetFieldConstraint(pGenerator, offsetof(SinglePatch, fm_lag.fm_dest), FIELD_RANGE, FMDESTINATIONTYPES_COUNT - 1);
+	SetFieldConstraint(pGenerator, offsetof(SinglePatch, fm_lag.lag_in), FIELD_RANGE, MODULATIONSOURCESFLAGS_COUNT - 1);
+	SetFieldConstraint(pGenerator, offsetof(SinglePatch, fm_lag.lag_mode), FIELD_FLAGS, GetFlagsMask(LagModeFlagsNames, LAGMODEFLAGS_COUNT));
+
+	// LFO (x5)
+	for (int i = 0; i < 5; i++) {
+		SetSection(pGenerator, ARRAY_ELEMENT_OFFSET(lfo, i), ARRAY_ELEMENT_SIZE(lfo), section++);
+		SetFieldConstraint(pGenerator, ARRAY_FIELD_OFFSET(lfo, i, retrig_mode), FIELD_RANGE, TRIGGERTYPES_COUNT - 1);
+		SetFieldConstraint(pGenerator, ARRAY_FIELD_OFFSET(lfo, i, lag), FIELD_FLAGS, GetFlagsMask(LagFlagsNames, LAGFLAGS_COUNT));
+		SetFieldConstraint(pGenerator, ARRAY_FIELD_OFFSET(lfo, i, wave), FIELD_RANGE, WAVETYPES_COUNT - 1);
+		SetFieldConstraint(pGenerator, ARRAY_FIELD_OFFSET(lfo, i, sample), FIELD_RANGE, MODULATIONSOURCESFLAGS_COUNT - 1);
+	}
+
+	// ENV (x5)
+	for (int i = 0; i < 5; i++) {
+		SetSection(pGenerator, ARRAY_ELEMENT_OFFSET(env, i), ARRAY_ELEMENT_SIZE(env), section++);
+		SetFieldConstraint(pGenerator, ARRAY_FIELD_OFFSET(env, i, flags), FIELD_FLAGS,
+			GetFlagsMask(EnveloppeModeFlagsNames, ENVELOPPEMODEFLAGS_COUNT) & ~ENVMODE_INVALID_VALUE);
+		SetFieldConstraint(pGenerator, ARRAY_FIELD_OFFSET(env, i, lfotrig), FIELD_RANGE, LFOTRIGGERCODES_COUNT - 1);
+	}
+
+	// TRACK (x3)
+	for (int i = 0; i < 3; i++) {
+		SetSection(pGenerator, ARRAY_ELEMENT_OFFSET(track, i), ARRAY_ELEMENT_SIZE(track), section++);
+		SetFieldConstraint(pGenerator, ARRAY_FIELD_OFFSET(track, i, input), FIELD_RANGE, MODULATIONSOURCESFLAGS_COUNT - 1);
+	}
+
+	// RAMP (x4)
+	for (int i = 0; i < 4; i++) {
+		SetSection(pGenerator, ARRAY_ELEMENT_OFFSET(ramp, i), ARRAY_ELEMENT_SIZE(ramp), section++);
+		SetFieldConstraint(pGenerator, ARRAY_FIELD_OFFSET(ramp, i, flags), FIELD_FLAGS, GetFlagsMask(RampFlagsNames, RAMPFLAGS_COUNT));
+		SetFieldConstraint(pGenerator, ARRAY_FIELD_OFFSET(ramp, i, lfotrig), FIELD_RANGE, LFOTRIGGERCODES_COUNT - 1);
+	}
+
+	// MOD MATRIX (x20): amount, sign and quantize use all the 8 bits
+	for (int i = 0; i < MODULATION_MAX_ENTRIES; i++) {
+		SetSection(pGenerator, ARRAY_ELEMENT_OFFSET(mod, i), ARRAY_ELEMENT_SIZE(mod), section++);
+		SetFieldConstraint(pGenerator, ARRAY_FIELD_OFFSET(mod, i, source), FIELD_MOD_ROUTING, MODULATION_SOURCE_COUNT - 1);
+		SetFieldConstraint(pGenerator, ARRAY_FIELD_OFFSET(mod, i, amountSignAndQuantize), FIELD_ANY, 0xFF);
+		SetFieldConstraint(pGenerator, ARRAY_FIELD_OFFSET(mod, i, dest), FIELD_MOD_ROUTING, MODULATION_DEST_COUNT - 1);
+	}
+}
+
+//----------------------------------------------------------------------------
+bool InitPatchGenerator(PatchGenerator* pGenerator, const SinglePatch* pParents, int parentCount, unsigned int seed) {
+	memset(pGenerator, 0, sizeof(PatchGenerator));
+	if (parentCount < 1) {
+		return false;
+	}
+	pGenerator->pParents = (SinglePatch*)malloc(parentCount * sizeof(SinglePatch));
+	if (pGenerator->pParents == NULL) {
+		return false;
+	}
+	pGenerator->parentCount = parentCount;
+
+	BuildFieldTables(pGenerator);
+	SetMutationRate(pGenerator, 0, OBWORDS_DATA_LENGTH, DEFAULT_MUTATION_RATE);
+	SetCrossoverRate(pGenerator, DEFAULT_CROSSOVER_RATE);
+	SeedPatchRng(&pGenerator->rng, seed);
+
+	// parents must be valid for their fields to be reused as is
+	memcpy(pGenerator->pParents, pParents, parentCount * sizeof(SinglePatch));
+	for (int i = 0; i < parentCount; i++) {
+		SanitizePatch(pGenerator, &pGenerator->pParents[i]);
+	}
+	return true;
+}
+
+//----------------------------------------------------------------------------
+void ReleasePatchGenerator(PatchGenerator* pGenerator) {
+	free(pGenerator->pParents);
+	memset(pGenerator, 0, sizeof(PatchGenerator));
+}
+
+//----------------------------------------------------------------------------
+/*! Convert a probability to a threshold for 16 bits random values
+*/
+static unsigned int GetRateThreshold(double rate) {
+	if (rate <= 0.0) {
+		return 0;
+	}
+	if (rate >= 1.0) {
+		return 65536;
+	}
+	return (unsigned int)(rate * 65536.0);
+}
+
+//----------------------------------------------------------------------------
+void SetMutationRate(PatchGenerator* pGenerator, size_t offset, size_t size, double rate) {
+	unsigned int threshold = GetRateThreshold(rate);
+	for (size_t i = offset; i < offset + size && i < (size_t)OBWORDS_DATA_LENGTH; i++) {
+		pGenerator->mutationThresholds[i] = threshold;
+	}
+}
+
+//----------------------------------------------------------------------------
+void SetCrossoverRate(PatchGenerator* pGenerator, double rate) {
+	pGenerator->crossoverThreshold = GetRateThreshold(rate);
+}
+
+//----------------------------------------------------------------------------
+void SanitizePatch(const PatchGenerator* pGenerator, SinglePatch* pPatch) {
+	unsigned char* pByte = (unsigned char*)pPatch;
+	for (int i = 0; i < OBWORDS_DATA_LENGTH; i++) {
+		const FieldConstraint* pConstraint = &pGenerator->constraints[i];
+		switch (pConstraint->kind) {
+		case FIELD_RANGE:
+			if (pByte[i] > pConstraint->maxValue) {
+				pByte[i] = pConstraint->maxValue;
+			}
+			break;
+		case FIELD_SIGNED_RANGE:
+			if ((signed char)pByte[i] > (signed char)pConstraint->maxValue) {
+				pByte[i] = pConstraint->maxValue;
+			}
+			else if ((signed char)pByte[i] < -(signed char)pConstraint->maxValue) {
+				pByte[i] = (unsigned char)(-(signed char)pConstraint->maxValue);
+			}
+			break;
+		case FIELD_FLAGS:
+			pByte[i] &= pConstraint->maxValue;
+			break;
+		case FIELD_MOD_ROUTING:
+			// out of range modulation routings are unused entries, written as maxValue + 1
+			if (pByte[i] > pConstraint->maxValue + 1) {
+				pByte[i] = pConstraint->maxValue + 1;
+			}
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+//----------------------------------------------------------------------------
+bool IsPatchValid(const PatchGenerator* pGenerator, const SinglePatch* pPatch) {
+	SinglePatch sanitized = *pPatch;
+	SanitizePatch(pGenerator, &sanitized);
+	return memcmp(&sanitized, pPatch, OBWORDS_DATA_LENGTH) == 0;
+}
+
+//----------------------------------------------------------------------------
+void GeneratePatches(PatchGenerator* pGenerator, SinglePatch* pPatches, int count) {
+	unsigned int randomValues[RANDOM_VALUES_PER_PATCH];
+
+	for (int n = 0; n < count; n++) {
+		FillPatchRng(&pGenerator->rng, randomValues, RANDOM_VALUES_PER_PATCH);
+
+		// first parent, also gives the name
+		const SinglePatch* pParentA = &pGenerator->pParents[
+			((unsigned long long)randomValues[RANDOM_PARENT_A] * pGenerator->parentCount) >> 32];
+		SinglePatch* pChild = &pPatches[n];
+		*pChild = *pParentA;
+		unsigned char* pChildByte = (unsigned char*)pChild;
+
+		// crossover: each section from one parent or the other
+		if ((randomValues[RANDOM_CROSSOVER] >> 16) < pGenerator->crossoverThreshold) {
+			const unsigned char* pParentBByte = (const unsigned char*)&pGenerator->pParents[
+				((unsigned long long)randomValues[RANDOM_PARENT_B] * pGenerator->parentCount) >> 32];
+			unsigned long long choice = ((unsigned long long)randomValues[RANDOM_SECTIONS_HIGH] << 32)
+				| randomValues[RANDOM_SECTIONS_LOW];
+			for (int i = 0; i < OBWORDS_DATA_LENGTH; i++) {
+				pChildByte[i] = ((choice >> pGenerator->sections[i]) & 1) ? pParentBByte[i] : pChildByte[i];
+			}
+		}
+
+		// mutation: high 16 bits decide, low 16 bits give the new value
+		for (int i = 0; i < OBWORDS_DATA_LENGTH; i++) {
+			unsigned int random = randomValues[i];
+			unsigned char newValue = (unsigned char)((pGenerator->valueBases[i]
+				+ (((random & 0xFFFF) * pGenerator->valueCounts[i]) >> 16)) & pGenerator->valueMasks[i]);
+			pChildByte[i] = ((random >> 16) < pGenerator->mutationThresholds[i]) ? newValue : pChildByte[i];
+		}
+	}
+}
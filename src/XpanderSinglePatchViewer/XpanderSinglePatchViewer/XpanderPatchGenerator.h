@@ -0,0 +1,142 @@
+//This file is part of XpanderSinglePatchViewer
+
+//XpanderSinglePatchViewer is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//XpanderSinglePatchViewer is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with XpanderSinglePatchViewer.
+//If not, see <http://www.gnu.org/licenses/>.
+
+//============================================================================
+// Patch generation engine: new single patches are generated from a pool of
+// parent patches, by crossing two parents (each section of the patch: VCO,
+// VCF, LFO, ENV... is taken from one of them) then mutating fields.
+// Every generated patch is valid: each field stays in the range given by
+// XpanderSysEx.h (enum counts, flags masks, signed detune, modulation
+// amount/sign/quantize packing).
+// The inner loops work on the 188 packed bytes with per-field tables and
+// a multi-lane xorshift PRNG, so that the compiler can vectorize them.
+//============================================================================
+
+#ifndef _XPANDERPATCHGENERATOR__
+#define _XPANDERPATCHGENERATOR__
+
+#include <stddef.h>
+
+#include "XpanderSysEx.h"
+
+// number of independent xorshift generators
+static const int PATCH_RNG_LANES = 8;
+
+typedef struct _PatchRng {
+	unsigned int state[PATCH_RNG_LANES];
+} PatchRng;
+
+//----------------------------------------------------------------------------
+/*! Seed a PRNG
+@param [out] pRng: the PRNG to seed
+@param [in] seed: any value
+*/
+void SeedPatchRng(PatchRng* pRng, unsigned int seed);
+
+//----------------------------------------------------------------------------
+/*! Get some 32 bits random values
+@param [in] pRng: the PRNG
+@param [out] pValues: the random values
+@param [in] count: number of values
+*/
+void FillPatchRng(PatchRng* pRng, unsigned int* pValues, int count);
+
+// valid values of a SinglePatch field
+typedef enum _FieldConstraintKinds {
+	FIELD_RANGE,		// 0 to maxValue
+	FIELD_SIGNED_RANGE,	// -maxValue to maxValue
+	FIELD_FLAGS,		// any combination of the maxValue bits
+	FIELD_MOD_ROUTING,	// 0 to maxValue, or maxValue + 1 for an unused modulation entry
+	FIELD_ANY			// any 8 bits value
+} FieldConstraintKinds;
+
+typedef struct _FieldConstraint {
+	unsigned char kind;		// FieldConstraintKinds
+	unsigned char maxValue;
+} FieldConstraint;
+
+typedef struct _PatchGenerator {
+	// per field tables, one entry per SinglePatch byte
+	FieldConstraint constraints[OBWORDS_DATA_LENGTH];
+	unsigned char sections[OBWORDS_DATA_LENGTH];			// crossover unit of the field
+	unsigned int mutationThresholds[OBWORDS_DATA_LENGTH];	// mutation probability * 65536
+	unsigned int valueCounts[OBWORDS_DATA_LENGTH];			// a new value is:
+	unsigned char valueBases[OBWORDS_DATA_LENGTH];			// (base + random * count / 65536)
+	unsigned char valueMasks[OBWORDS_DATA_LENGTH];			// & mask
+
+	SinglePatch* pParents;		// valid copies of the parent patches
+	int parentCount;
+	unsigned int crossoverThreshold;	// crossover probability * 65536
+	PatchRng rng;
+} PatchGenerator;
+
+//----------------------------------------------------------------------------
+/*! Initialize a generator
+@param [out] pGenerator: the generator to initialize
+@param [in] pParents: the parent patches, copied and made valid
+@param [in] parentCount: number of parent patches, at least 1
+@param [in] seed: PRNG seed
+@return false on memory allocation error or without parents
+@remark default mutation rate is 5% for every field, default crossover rate 50%
+*/
+bool InitPatchGenerator(PatchGenerator* pGenerator, const SinglePatch* pParents, int parentCount, unsigned int seed);
+
+//----------------------------------------------------------------------------
+/*! Free the parent patches of a generator
+@param [in] pGenerator: the generator to release
+*/
+void ReleasePatchGenerator(PatchGenerator* pGenerator);
+
+//----------------------------------------------------------------------------
+/*! Set the mutation rate of some fields
+@param [in] pGenerator: the generator
+@param [in] offset: offset of the first field in SinglePatch, e.g. offsetof(SinglePatch, lfo)
+@param [in] size: size of the fields, e.g. sizeof(((SinglePatch*)0)->lfo)
+@param [in] rate: mutation probability of each field, 0.0 to 1.0
+*/
+void SetMutationRate(PatchGenerator* pGenerator, size_t offset, size_t size, double rate);
+
+//----------------------------------------------------------------------------
+/*! Set the probability to cross two parents, instead of copying one, before mutation
+@param [in] pGenerator: the generator
+@param [in] rate: crossover probability, 0.0 to 1.0
+*/
+void SetCrossoverRate(PatchGenerator* pGenerator, double rate);
+
+//----------------------------------------------------------------------------
+/*! Make a patch valid: out of range fields are brought back in range
+@param [in] pGenerator: the generator giving the field constraints
+@param [in] pPatch: the patch to check
+*/
+void SanitizePatch(const PatchGenerator* pGenerator, SinglePatch* pPatch);
+
+//----------------------------------------------------------------------------
+/*! Check that all the fields of a patch are valid
+@param [in] pGenerator: the generator giving the field constraints
+@param [in] pPatch: the patch to check
+@return true if the patch is valid
+*/
+bool IsPatchValid(const PatchGenerator* pGenerator, const SinglePatch* pPatch);
+
+//----------------------------------------------------------------------------
+/*! Generate new patches
+@param [in] pGenerator: the generator
+@param [out] pPatches: the generated patches, named after their first parent
+@param [in] count: number of patches to generate
+*/
+void GeneratePatches(PatchGenerator* pGenerator, SinglePatch* pPatches, int count);
+
+#endif // _XPANDERPATCHGENERATOR__
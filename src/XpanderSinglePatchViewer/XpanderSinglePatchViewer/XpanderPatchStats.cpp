@@ -0,0 +1,377 @@
+//This file is part of XpanderSinglePatchViewer
+
+//XpanderSinglePatchViewer is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//XpanderSinglePatchViewer is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with XpanderSinglePatchViewer.
+//If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include <windows.h>
+
+//stdlib
+#include <stdlib.h>
+#include <string.h>
+
+#include "XpanderPatchStats.h"
+#include "XpanderPatchFields.h"
+#include "XpanderDecodeContext.h"
+#include "XpanderMappedFile.h"
+
+// patches decoded at once by each thread
+static const int STATS_BATCH_SIZE = 1024;
+// most frequent routings printed
+static const int TOP_ROUTINGS_COUNT = 20;
+
+static const char* DOUBLE_LINE = "===========================\n";
+
+//----------------------------------------------------------------------------
+void ClearPatchStatsCounters(PatchStatsCounters* pCounters) {
+	memset(pCounters, 0, sizeof(PatchStatsCounters));
+}
+
+//----------------------------------------------------------------------------
+void CountPatch(PatchStatsCounters* pCounters, const SinglePatch* pPatch) {
+	// one histogram per byte: no dependency between two increments
+	const unsigned char* pByte = (const unsigned char*)pPatch;
+	for (int i = 0; i < OBWORDS_DATA_LENGTH; i++) {
+		pCounters->histograms[i][pByte[i]]++;
+	}
+	// used modulation entries only
+	for (int i = 0; i < MODULATION_MAX_ENTRIES; i++) {
+		unsigned char source = pPatch->mod[i].source;
+		unsigned char dest = pPatch->mod[i].dest;
+		if (source < MODULATION_SOURCE_COUNT && dest < MODULATION_DEST_COUNT) {
+			pCounters->routings[source][dest]++;
+		}
+	}
+	pCounters->patchCount++;
+}
+
+//----------------------------------------------------------------------------
+void InitPatchStats(PatchStats* pStats) {
+	memset(pStats, 0, sizeof(PatchStats));
+}
+
+//----------------------------------------------------------------------------
+void MergePatchStats(PatchStats* pStats, PatchStatsCounters* pCounters) {
+	// flat arrays: vectorizable
+	unsigned long long* pTotals = &pStats->histograms[0][0];
+	const unsigned int* pCounts = &pCounters->histograms[0][0];
+	for (int i = 0; i < OBWORDS_DATA_LENGTH * PATCH_STATS_BINS; i++) {
+		pTotals[i] += pCounts[i];
+	}
+	pTotals = &pStats->routings[0][0];
+	pCounts = &pCounters->routings[0][0];
+	for (int i = 0; i < MODULATION_SOURCE_COUNT * MODULATION_DEST_COUNT; i++) {
+		pTotals[i] += pCounts[i];
+	}
+	pStats->patchCount += pCounters->patchCount;
+	ClearPatchStatsCounters(pCounters);
+}
+
+//----------------------------------------------------------------------------
+// work shared by the ComputeCorpusStats() threads
+typedef struct _StatsJob {
+	const char* const* ppszFileNames;
+	int fileCount;
+	volatile LONG nextFile;		// index of the next file to count, taken with InterlockedIncrement
+} StatsJob;
+
+typedef struct _StatsWorker {
+	HANDLE hThread;
+	StatsJob* pJob;
+	PatchStatsCounters* pCounters;	// counters of this thread
+	PatchStats* pTotals;			// totals of this thread, for counters overflow
+	int failedCount;
+	bool bOk;
+} StatsWorker;
+
+//----------------------------------------------------------------------------
+/*! Count the patches of one file
+@return false if the file could not be read
+*/
+static bool CountFilePatches(StatsWorker* pWorker, DecodeContext* pContext, const char* pszFileName) {
+	MappedFile mapped;
+	if (!MapInputFile(pszFileName, &mapped)) {
+		return false;
+	}
+	size_t offset = 0;
+	while (offset < mapped.size) {
+		DecodeContextReset(pContext);
+		offset = DecodeBatch(pContext, mapped.pData, mapped.size, offset, DECODE_FLAG_NONE);
+		if (pWorker->pCounters->patchCount > PATCH_STATS_MAX_COUNTED_PATCHES - (unsigned int)pContext->patchCount) {
+			MergePatchStats(pWorker->pTotals, pWorker->pCounters);
+		}
+		for (int i = 0; i < pContext->patchCount; i++) {
+			CountPatch(pWorker->pCounters, &pContext->pPatches[i].patch);
+		}
+	}
+	UnmapInputFile(&mapped);
+	return true;
+}
+
+//----------------------------------------------------------------------------
+/*! Thread: count the files until there are none left
+*/
+static DWORD WINAPI StatsThreadProc(LPVOID pParameter) {
+	StatsWorker* pWorker = (StatsWorker*)pParameter;
+	DecodeContext context;
+	if (!DecodeContextInit(&context, STATS_BATCH_SIZE, STATS_BATCH_SIZE * (PATCHNAME_LENGTH + 8))) {
+		pWorker->bOk = false;
+		return 1;
+	}
+	for (;;) {
+		int file = InterlockedIncrement(&pWorker->pJob->nextFile) - 1;
+		if (file >= pWorker->pJob->fileCount) {
+			break;
+		}
+		if (!CountFilePatches(pWorker, &context, pWorker->pJob->ppszFileNames[file])) {
+			pWorker->failedCount++;
+		}
+	}
+	DecodeContextRelease(&context);
+	pWorker->bOk = true;
+	return 0;
+}
+
+//----------------------------------------------------------------------------
+bool ComputeCorpusStats(const char* const* ppszFileNames, int fileCount, int threadCount, PatchStats* pStats, int* pFailedCount) {
+	InitPatchStats(pStats);
+	*pFailedCount = 0;
+	if (threadCount < 1) {
+		threadCount = 1;
+	}
+
+	StatsJob job;
+	job.ppszFileNames = ppszFileNames;
+	job.fileCount = fileCount;
+	job.nextFile = 0;
+
+	StatsWorker* pWorkers = (StatsWorker*)calloc(threadCount, sizeof(StatsWorker));
+	if (pWorkers == NULL) {
+		return false;
+	}
+	bool bOk = true;
+	int startedCount = 0;
+	for (; startedCount < threadCount; startedCount++) {
+		StatsWorker* pWorker = &pWorkers[startedCount];
+		pWorker->pJob = &job;
+		pWorker->pCounters = (PatchStatsCounters*)calloc(1, sizeof(PatchStatsCounters));
+		pWorker->pTotals = (PatchStats*)calloc(1, sizeof(PatchStats));
+		if (pWorker->pCounters == NULL || pWorker->pTotals == NULL) {
+			bOk = false;
+			break;
+		}
+		pWorker->hThread = CreateThread(NULL, 0, StatsThreadProc, pWorker, 0, NULL);
+		if (pWorker->hThread == NULL) {
+			bOk = false;
+			break;
+		}
+	}
+
+	// the threads share nothing until they are done
+	for (int i = 0; i < startedCount; i++) {
+		WaitForSingleObject(pWorkers[i].hThread, INFINITE);
+		CloseHandle(pWorkers[i].hThread);
+		bOk = bOk && pWorkers[i].bOk;
+		*pFailedCount += pWorkers[i].failedCount;
+		MergePatchStats(pWorkers[i].pTotals, pWorkers[i].pCounters);
+		// totals of a thread into the totals
+		for (int j = 0; j < OBWORDS_DATA_LENGTH * PATCH_STATS_BINS; j++) {
+			(&pStats->histograms[0][0])[j] += (&pWorkers[i].pTotals->histograms[0][0])[j];
+		}
+		for (int j = 0; j < MODULATION_SOURCE_COUNT * MODULATION_DEST_COUNT; j++) {
+			(&pStats->routings[0][0])[j] += (&pWorkers[i].pTotals->routings[0][0])[j];
+		}
+		pStats->patchCount += pWorkers[i].pTotals->patchCount;
+	}
+	for (int i = 0; i < threadCount; i++) {
+		free(pWorkers[i].pCounters);
+		free(pWorkers[i].pTotals);
+	}
+	free(pWorkers);
+	return bOk;
+}
+
+//----------------------------------------------------------------------------
+/*! Value of a histogram bin, as a number
+*/
+static int GetBinValue(const PatchField* pField, int bin) {
+	return (pField->kind == PATCHFIELD_SIGNED) ? (int)(signed char)bin : bin;
+}
+
+//----------------------------------------------------------------------------
+/*! Label of a histogram bin: code name or flags names
+*/
+static void GetBinLabel(const PatchField* pField, int bin, char* pszLabel, size_t labelSize) {
+	pszLabel[0] = '\0';
+	switch (pField->kind) {
+	case PATCHFIELD_ENUM:
+	case PATCHFIELD_MOD_SOURCE:
+	case PATCHFIELD_MOD_DEST:
+		strcpy_s(pszLabel, labelSize, (bin < pField->count) ? pField->ppszValueNames[bin] : "UNUSED");
+		break;
+	case PATCHFIELD_FLAGS:
+		for (int i = 0; i < pField->count; i++) {
+			if ((bin & pField->pFlags[i].iNumber) == pField->pFlags[i].iNumber) {
+				if (pszLabel[0] != '\0') {
+					strcat_s(pszLabel, labelSize, " ");
+				}
+				strcat_s(pszLabel, labelSize, pField->pFlags[i].pszString);
+			}
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+//----------------------------------------------------------------------------
+void PrintPatchStats(const PatchStats* pStats, OutputSink* pSink) {
+	char szLabel[256];
+	double patchCount = (pStats->patchCount > 0) ? (double)pStats->patchCount : 1.0;
+
+	SinkPrintf(pSink, DOUBLE_LINE);
+	SinkPrintf(pSink, "Patches:\t %llu\n", pStats->patchCount);
+	SinkPrintf(pSink, DOUBLE_LINE);
+	SinkPrintf(pSink, "%-28s %5s %5s %8s %5s %7s %8s\n", "FIELD", "MIN", "MAX", "MEAN", "MODE", "MODE%", "DISTINCT");
+	for (int i = 0; i < OBWORDS_DATA_LENGTH; i++) {
+		const PatchField* pField = &PatchFields[i];
+		const unsigned long long* pHistogram = pStats->histograms[i];
+		int minValue = 0, maxValue = 0, modeBin = 0, distinctCount = 0;
+		double sum = 0.0;
+		for (int bin = 0; bin < PATCH_STATS_BINS; bin++) {
+			if (pHistogram[bin] == 0) {
+				continue;
+			}
+			int value = GetBinValue(pField, bin);
+			if (distinctCount == 0 || value < minValue) {
+				minValue = value;
+			}
+			if (distinctCount == 0 || value > maxValue) {
+				maxValue = value;
+			}
+			if (pHistogram[bin] > pHistogram[modeBin]) {
+				modeBin = bin;
+			}
+			sum += (double)value * pHistogram[bin];
+			distinctCount++;
+		}
+		SinkPrintf(pSink, "%-28s %5d %5d %8.2f %5d %6.2f%% %8d\n", pField->pszName, minValue, maxValue, sum / patchCount,
+			GetBinValue(pField, modeBin), 100.0 * pHistogram[modeBin] / patchCount, distinctCount);
+	}
+
+	// codes and flags usage
+	SinkPrintf(pSink, DOUBLE_LINE);
+	SinkPrintf(pSink, "CODES AND FLAGS USAGE\n");
+	for (int i = 0; i < OBWORDS_DATA_LENGTH; i++) {
+		const PatchField* pField = &PatchFields[i];
+		const unsigned long long* pHistogram = pStats->histograms[i];
+		if (pField->kind == PATCHFIELD_ENUM) {
+			SinkPrintf(pSink, "%s:\n", pField->pszName);
+			for (int bin = 0; bin < PATCH_STATS_BINS; bin++) {
+				if (pHistogram[bin] > 0) {
+					GetBinLabel(pField, bin, szLabel, sizeof(szLabel));
+					SinkPrintf(pSink, "\t%-20s %12llu %6.2f%%\n", (bin < pField->count) ? szLabel : "OUT OF RANGE",
+						pHistogram[bin], 100.0 * pHistogram[bin] / patchCount);
+				}
+			}
+		}
+		else if (pField->kind == PATCHFIELD_FLAGS) {
+			SinkPrintf(pSink, "%s:\n", pField->pszName);
+			for (int j = 0; j < pField->count; j++) {
+				unsigned long long flagCount = 0;
+				for (int bin = 0; bin < PATCH_STATS_BINS; bin++) {
+					if ((bin & pField->pFlags[j].iNumber) == pField->pFlags[j].iNumber) {
+						flagCount += pHistogram[bin];
+					}
+				}
+				SinkPrintf(pSink, "\t%-20s %12llu %6.2f%%\n", pField->pFlags[j].pszString, flagCount, 100.0 * flagCount / patchCount);
+			}
+		}
+	}
+
+	// most frequent routings, all modulation entries together
+	SinkPrintf(pSink, DOUBLE_LINE);
+	SinkPrintf(pSink, "MOST FREQUENT MODULATION ROUTINGS\n");
+	unsigned long long usedCount = 0;
+	for (int i = 0; i < MODULATION_SOURCE_COUNT * MODULATION_DEST_COUNT; i++) {
+		usedCount += (&pStats->routings[0][0])[i];
+	}
+	SinkPrintf(pSink, "Used entries:\t %llu (%.2f per patch)\n", usedCount, usedCount / patchCount);
+	unsigned long long previousCount = ~0ULL;
+	int previousIndex = -1;
+	for (int n = 0; n < TOP_ROUTINGS_COUNT; n++) {
+		// next one in (count desc, index asc) order
+		int bestIndex = -1;
+		for (int i = 0; i < MODULATION_SOURCE_COUNT * MODULATION_DEST_COUNT; i++) {
+			unsigned long long count = (&pStats->routings[0][0])[i];
+			if (count == 0 || count > previousCount || (count == previousCount && i <= previousIndex)) {
+				continue;
+			}
+			if (bestIndex < 0 || count > (&pStats->routings[0][0])[bestIndex]) {
+				bestIndex = i;
+			}
+		}
+		if (bestIndex < 0) {
+			break;
+		}
+		previousCount = (&pStats->routings[0][0])[bestIndex];
+		previousIndex = bestIndex;
+		SinkPrintf(pSink, "\t%-10s -> %-10s %12llu\n", ModulationSourcesFlagsNames[bestIndex / MODULATION_DEST_COUNT],
+			ModulationDestinationsTypesNames[bestIndex % MODULATION_DEST_COUNT], previousCount);
+	}
+}
+
+//----------------------------------------------------------------------------
+bool WritePatchStatsCsv(const PatchStats* pStats, const char* pszFieldsFileName, const char* pszRoutingsFileName) {
+	char szLabel[256];
+
+	FILE* pFile = NULL;
+	fopen_s(&pFile, pszFieldsFileName, "w");
+	if (pFile == NULL) {
+		return false;
+	}
+	fprintf(pFile, "field,offset,value,label,count\n");
+	for (int i = 0; i < OBWORDS_DATA_LENGTH; i++) {
+		const PatchField* pField = &PatchFields[i];
+		for (int bin = 0; bin < PATCH_STATS_BINS; bin++) {
+			if (pStats->histograms[i][bin] > 0) {
+				GetBinLabel(pField, bin, szLabel, sizeof(szLabel));
+				fprintf(pFile, "%s,%d,%d,%s,%llu\n", pField->pszName, i, GetBinValue(pField, bin), szLabel, pStats->histograms[i][bin]);
+			}
+		}
+	}
+	bool bOk = (ferror(pFile) == 0);
+	fclose(pFile);
+	if (!bOk) {
+		return false;
+	}
+
+	pFile = NULL;
+	fopen_s(&pFile, pszRoutingsFileName, "w");
+	if (pFile == NULL) {
+		return false;
+	}
+	fprintf(pFile, "source,dest,count\n");
+	for (int source = 0; source < MODULATION_SOURCE_COUNT; source++) {
+		for (int dest = 0; dest < MODULATION_DEST_COUNT; dest++) {
+			if (pStats->routings[source][dest] > 0) {
+				fprintf(pFile, "%s,%s,%llu\n", ModulationSourcesFlagsNames[source], ModulationDestinationsTypesNames[dest],
+					pStats->routings[source][dest]);
+			}
+		}
+	}
+	bOk = (ferror(pFile) == 0);
+	fclose(pFile);
+	return bOk;
+}
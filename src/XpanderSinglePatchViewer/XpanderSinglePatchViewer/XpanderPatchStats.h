@@ -0,0 +1,109 @@
+//This file is part of XpanderSinglePatchViewer
+
+//XpanderSinglePatchViewer is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//XpanderSinglePatchViewer is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with XpanderSinglePatchViewer.
+//If not, see <http://www.gnu.org/licenses/>.
+
+//============================================================================
+// Corpus statistics: 256 bins value histogram of each of the 188 SinglePatch
+// bytes and modulation routings (source x destination) counts.
+// Each thread counts into its own PatchStatsCounters, a flat array of 32 bits
+// counters, merged into the 64 bits PatchStats totals at the end: counting
+// shares no memory between threads and merging is a vectorizable loop.
+//============================================================================
+
+#ifndef _XPANDERPATCHSTATS__
+#define _XPANDERPATCHSTATS__
+
+#include "XpanderSysEx.h"
+#include "XpanderOutputSink.h"
+
+static const int PATCH_STATS_BINS = 256;
+// counters must be merged before overflowing
+static const unsigned int PATCH_STATS_COUNTERS_LIMIT = 0xFFFFFFFF;
+// a routing counter can be incremented by each modulation entry of a patch:
+// patches that can be counted before merging
+static const unsigned int PATCH_STATS_MAX_COUNTED_PATCHES = PATCH_STATS_COUNTERS_LIMIT / MODULATION_MAX_ENTRIES;
+
+// per thread counters
+typedef struct _PatchStatsCounters {
+	unsigned int histograms[OBWORDS_DATA_LENGTH][PATCH_STATS_BINS];
+	unsigned int routings[MODULATION_SOURCE_COUNT][MODULATION_DEST_COUNT];
+	unsigned int patchCount;
+} PatchStatsCounters;
+
+// merged totals
+typedef struct _PatchStats {
+	unsigned long long histograms[OBWORDS_DATA_LENGTH][PATCH_STATS_BINS];
+	unsigned long long routings[MODULATION_SOURCE_COUNT][MODULATION_DEST_COUNT];
+	unsigned long long patchCount;
+} PatchStats;
+
+//----------------------------------------------------------------------------
+/*! Set all the counters to 0
+@param [out] pCounters: the counters to clear
+*/
+void ClearPatchStatsCounters(PatchStatsCounters* pCounters);
+
+//----------------------------------------------------------------------------
+/*! Count the values of a patch
+@param [in] pCounters: the counters
+@param [in] pPatch: the patch to count
+@remark merge the counters before pCounters->patchCount reaches PATCH_STATS_MAX_COUNTED_PATCHES
+*/
+void CountPatch(PatchStatsCounters* pCounters, const SinglePatch* pPatch);
+
+//----------------------------------------------------------------------------
+/*! Set all the totals to 0
+@param [out] pStats: the totals to clear
+*/
+void InitPatchStats(PatchStats* pStats);
+
+//----------------------------------------------------------------------------
+/*! Add counters to the totals, then clear the counters
+@param [in] pStats: the totals
+@param [in] pCounters: the counters to merge
+*/
+void MergePatchStats(PatchStats* pStats, PatchStatsCounters* pCounters);
+
+//----------------------------------------------------------------------------
+/*! Count the patches of some files with several threads
+@param [in] ppszFileNames: the sysex files
+@param [in] fileCount: number of files
+@param [in] threadCount: number of threads, at least 1
+@param [out] pStats: the totals
+@param [out] pFailedCount: number of files that could not be read
+@return false on thread or memory allocation error
+*/
+bool ComputeCorpusStats(const char* const* ppszFileNames, int fileCount, int threadCount, PatchStats* pStats, int* pFailedCount);
+
+//----------------------------------------------------------------------------
+/*! Write the summary tables: per field min/max/mean/most frequent value,
+enum and flags usage, most frequent modulation routings
+@param [in] pStats: the totals
+@param [in] pSink: where to write to
+*/
+void PrintPatchStats(const PatchStats* pStats, OutputSink* pSink);
+
+//----------------------------------------------------------------------------
+/*! Export the totals as CSV
+@param [in] pStats: the totals
+@param [in] pszFieldsFileName: histograms file: field,offset,value,label,count
+(non zero counts only)
+@param [in] pszRoutingsFileName: routings file: source,dest,count (non zero
+counts only)
+@return false if a file can not be written
+*/
+bool WritePatchStatsCsv(const PatchStats* pStats, const char* pszFieldsFileName, const char* pszRoutingsFileName);
+
+#endif // _XPANDERPATCHSTATS__
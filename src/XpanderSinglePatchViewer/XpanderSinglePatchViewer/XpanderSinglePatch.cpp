@@ -0,0 +1,456 @@
+//This file is part of XpanderSinglePatchViewer
+
+//XpanderSinglePatchViewer is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//XpanderSinglePatchViewer is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with XpanderSinglePatchViewer.
+//If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+//stdlib
+#include <assert.h>
+#include <string.h>
+
+#include "XpanderSinglePatch.h"
+
+// UI stuff :)
+static const char* SINGLE_LINE = "---------------------------\n";
+static const char* DOUBLE_LINE = "===========================\n";
+
+//----------------------------------------------------------------------------
+bool IsSinglePatchIntro(const unsigned char* pIntro) {
+	// Single Patch data: F0 10 02 01 00...
+	return (pIntro[0] == 0xF0) && (pIntro[1] == 0x10) && (pIntro[2] == 0x02) && (pIntro[3] == 0x01) && (pIntro[4] == 0x00);
+}
+
+//----------------------------------------------------------------------------
+bool LocateSinglePatchData(FILE* pFile) {
+	bool bSinglePatchDataFound = false;
+	bool bEndOfFile = false;
+
+	unsigned char intro[PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH];
+
+	while (!bSinglePatchDataFound && !bEndOfFile) {
+		memset(intro, 0, PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH);
+		// try to identify Single Patch data: F0 10 02 01 00...
+		int nbBytesRead = fread(intro, sizeof(char), PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH, pFile);
+		if (nbBytesRead != PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH) { bEndOfFile = true; break; }
+		if (IsSinglePatchIntro(intro)) {
+			// bingo...
+			OutputSink sink;
+			InitFileSink(&sink, stdout);
+			DumpPatchHeader(intro, &sink);
+			{bSinglePatchDataFound = true; break; }
+		}
+		else {
+			// try one byte after beginning...
+			fseek(pFile, -(PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH - 1), SEEK_CUR);
+		}
+	}
+
+	return (!bEndOfFile);
+}
+
+//----------------------------------------------------------------------------
+size_t FindSinglePatchData(const unsigned char* pData, size_t size, size_t from) {
+	// the intro is followed by the data and the EOX
+	if (size < (size_t)SINGLE_PATCH_SYSEX_LENGTH) {
+		return size;
+	}
+	size_t last = size - SINGLE_PATCH_SYSEX_LENGTH;
+	for (size_t offset = from; offset <= last; offset++) {
+		// jump to the next sysex status byte
+		const unsigned char* pIntro = (const unsigned char*)memchr(pData + offset, 0xF0, last - offset + 1);
+		if (pIntro == NULL) {
+			break;
+		}
+		offset = pIntro - pData;
+		if (IsSinglePatchIntro(pIntro)) {
+			return offset;
+		}
+	}
+	return size;
+}
+
+//----------------------------------------------------------------------------
+void InitSinglePatchScanner(SinglePatchScanner* pScanner) {
+	pScanner->messageLength = 0;
+	pScanner->messageOffset = 0;
+	pScanner->position = 0;
+	pScanner->truncatedCount = 0;
+}
+
+//----------------------------------------------------------------------------
+void FeedSinglePatchScanner(SinglePatchScanner* pScanner, const unsigned char* pData, size_t size,
+	SinglePatchCallback pCallback, void* pUser) {
+	static const unsigned char INTRO[PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH - 1] = { 0xF0, 0x10, 0x02, 0x01, 0x00 };
+	static const int MESSAGE_LENGTH = PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH + SINGLE_PATCH_DATA_LENGTH;
+
+	const unsigned char* pEnd = pData + size;
+	while (pData < pEnd) {
+		if (pScanner->messageLength == 0) {
+			// jump to the next sysex status byte
+			const unsigned char* pStatus = (const unsigned char*)memchr(pData, 0xF0, pEnd - pData);
+			if (pStatus == NULL) {
+				pScanner->position += pEnd - pData;
+				break;
+			}
+			pScanner->position += pStatus - pData;
+			pScanner->messageOffset = pScanner->position;
+			pScanner->message[0] = 0xF0;
+			pScanner->messageLength = 1;
+			pScanner->position++;
+			pData = pStatus + 1;
+		}
+		else if (pScanner->messageLength < PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH - 1) {
+			// F0 10 02 01 00...
+			if (*pData != INTRO[pScanner->messageLength]) {
+				// not a single patch, this byte may start the next one
+				pScanner->messageLength = 0;
+				continue;
+			}
+			pScanner->message[pScanner->messageLength++] = *pData++;
+			pScanner->position++;
+		}
+		else if (pScanner->messageLength < MESSAGE_LENGTH) {
+			// program number and data: 7 bits values only
+			size_t missing = MESSAGE_LENGTH - pScanner->messageLength;
+			size_t available = pEnd - pData;
+			size_t count = (available < missing) ? available : missing;
+			size_t dataCount = 0;
+			while (dataCount < count && pData[dataCount] < 0x80) {
+				dataCount++;
+			}
+			memcpy(pScanner->message + pScanner->messageLength, pData, dataCount);
+			pScanner->messageLength += (int)dataCount;
+			pScanner->position += dataCount;
+			pData += dataCount;
+
+			if (dataCount < count) {
+				// cut by a status byte, which may start the next message
+				pScanner->truncatedCount++;
+				pScanner->messageLength = 0;
+				continue;
+			}
+		}
+		else {
+			// EOX
+			pScanner->messageLength = 0;
+			if (*pData != SYSEX_EOX) {
+				pScanner->truncatedCount++;
+				continue;
+			}
+			pData++;
+			pScanner->position++;
+
+			SinglePatch patch;
+			RepackSinglePatchData(pScanner->message + PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH, &patch);
+			pCallback(pUser, pScanner->messageOffset, pScanner->message, &patch);
+		}
+	}
+}
+
+//----------------------------------------------------------------------------
+void EndSinglePatchScanner(SinglePatchScanner* pScanner) {
+	if (pScanner->messageLength >= PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH - 1) {
+		pScanner->truncatedCount++;
+	}
+	pScanner->messageLength = 0;
+}
+
+//----------------------------------------------------------------------------
+void ReadSinglePatchData(FILE* pFile, SinglePatch* pPatch) {
+	//  data in sysex are double bytes values (short), followed by the name
+	unsigned char data[SINGLE_PATCH_DATA_LENGTH];
+	memset(data, 0, SINGLE_PATCH_DATA_LENGTH);
+
+	int iReadBytes = 0;
+	iReadBytes = fread(data, sizeof(char), SINGLE_PATCH_DATA_LENGTH, pFile);
+
+	assert(iReadBytes == SINGLE_PATCH_DATA_LENGTH);
+
+	RepackSinglePatchData(data, pPatch);
+}
+
+//----------------------------------------------------------------------------
+void RepackSinglePatchData(const unsigned char* pData, SinglePatch* pPatch) {
+	// for each double byte, repack the value, and set the Patch property accordingly
+	// (low byte first, 8th bit of the 8 bits value is the first bit of the high byte)
+	unsigned char* pByte = (unsigned char*)pPatch;
+	for (int i = 0; i < OBWORDS_DATA_LENGTH; i++) {
+		unsigned char cValue = ((pData[1] & 0x01) << 7) | pData[0];
+		*pByte = cValue;
+		pByte++;
+		pData += 2;
+	}
+
+	// name is 2 bytes/char, high byte never used, thus wchar_t compatible
+	for (int i = 0; i < PATCHNAME_LENGTH; i++) {
+		pPatch->name.character[i] = (wchar_t)(pData[0] | (pData[1] << 8));
+		pData += 2;
+	}
+	pPatch->name.character[PATCHNAME_LENGTH] = L'\0';
+}
+
+//----------------------------------------------------------------------------
+void EncodeSinglePatchData(const SinglePatch* pPatch, unsigned char programNumber, unsigned char* pMessage) {
+	// F0 10 02 01 00 <program>
+	pMessage[0] = 0xF0;
+	pMessage[1] = 0x10;
+	pMessage[2] = 0x02;
+	pMessage[3] = 0x01;
+	pMessage[4] = 0x00;
+	pMessage[5] = programNumber;
+	pMessage += PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH;
+
+	// 8 bits values as double bytes: lower 7 bits first, then the 8th bit
+	const unsigned char* pByte = (const unsigned char*)pPatch;
+	for (int i = 0; i < OBWORDS_DATA_LENGTH; i++) {
+		pMessage[0] = *pByte & 0x7F;
+		pMessage[1] = *pByte >> 7;
+		pByte++;
+		pMessage += 2;
+	}
+
+	for (int i = 0; i < PATCHNAME_LENGTH; i++) {
+		pMessage[0] = (unsigned char)(pPatch->name.character[i] & 0x7F);
+		pMessage[1] = 0x00;
+		pMessage += 2;
+	}
+
+	// EOX
+	pMessage[0] = 0xF7;
+}
+
+//----------------------------------------------------------------------------
+bool IsSinglePatchDumpable(const SinglePatch* pPatch) {
+	if (pPatch->vcf.fmode >= VCFFILTERTYPES_COUNT
+		|| pPatch->fm_lag.fm_dest >= FMDESTINATIONTYPES_COUNT
+		|| pPatch->fm_lag.lag_in >= MODULATIONSOURCESFLAGS_COUNT) {
+		return false;
+	}
+	for (int i = 0; i < 5; i++) {
+		if (pPatch->lfo[i].retrig_mode >= TRIGGERTYPES_COUNT
+			|| pPatch->lfo[i].wave >= WAVETYPES_COUNT
+			|| pPatch->lfo[i].sample >= MODULATIONSOURCESFLAGS_COUNT
+			|| pPatch->env[i].lfotrig >= LFOTRIGGERCODES_COUNT) {
+			return false;
+		}
+	}
+	for (int i = 0; i < 3; i++) {
+		if (pPatch->track[i].input >= MODULATIONSOURCESFLAGS_COUNT) {
+			return false;
+		}
+	}
+	for (int i = 0; i < 4; i++) {
+		if (pPatch->ramp[i].lfotrig >= LFOTRIGGERCODES_COUNT) {
+			return false;
+		}
+	}
+	// a 7 bits value repacked with its 8th bit set can not come from a 7 bits code
+	for (int i = 0; i < MODULATION_MAX_ENTRIES; i++) {
+		if (pPatch->mod[i].source >= 0x80 || pPatch->mod[i].dest >= 0x80) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//----------------------------------------------------------------------------
+void DumpPatchHeader(const unsigned char* pIntro, OutputSink* pSink) {
+	SinkPrintf(pSink, DOUBLE_LINE);
+	SinkPrintf(pSink, "Program type:\t %02Xh\nProgram number:\t %02Xh (%02d)\n", pIntro[4], pIntro[5], pIntro[5]);
+}
+
+//----------------------------------------------------------------------------
+void DumpPatch(const SinglePatch* pPatch, OutputSink* pSink) {
+	// NAME ------------------------------------
+	SinkPrintf(pSink, "NAME:\t%S\n", &pPatch->name);
+
+	// VCO1  ------------------------------------
+	SinkPrintf(pSink, SINGLE_LINE);
+	SinkPrintf(pSink, "VCO1.freq:\t %02Xh\t %4d\n", pPatch->vco[0].freq, pPatch->vco[0].freq);
+	SinkPrintf(pSink, "VCO1.detune:\t %02Xh\t %4d\n", pPatch->vco[0].detune, pPatch->vco[0].detune);
+	SinkPrintf(pSink, "VCO1.pw:\t %02Xh\t %4d\n", pPatch->vco[0].pw, pPatch->vco[0].pw);
+	SinkPrintf(pSink, "VCO1.vol:\t %02Xh\t %4d\n", pPatch->vco[0].vol, pPatch->vco[0].vol);
+	SinkPrintf(pSink, "VCO1.mod:\t %02Xh\t %4d : ", pPatch->vco[0].mod, pPatch->vco[0].mod);
+	// show bitfields
+	for (int i = 0; i < ::MODULATIONFLAGS_COUNT; i++) {
+		if ((ModulationFlagsNames[i].iNumber & pPatch->vco[0].mod) == ModulationFlagsNames[i].iNumber) {
+			SinkPrintf(pSink, "%s ", ModulationFlagsNames[i].pszString);
+		}
+	}
+	SinkPrintf(pSink, "\n");
+	SinkPrintf(pSink, "VCO1.wave:\t %02Xh\t %4d : ", pPatch->vco[0].wave, pPatch->vco[0].wave);
+	for (int i = 0; i < ::VCOWAVEFLAGS_COUNT; i++) {
+		if ((VCOWavesFlagsNames[i].iNumber & pPatch->vco[0].wave) == VCOWavesFlagsNames[i].iNumber) {
+			SinkPrintf(pSink, "%s ", VCOWavesFlagsNames[i].pszString);
+		}
+	}
+	SinkPrintf(pSink, "\n");
+
+	//VCO2 ------------------------------------
+	SinkPrintf(pSink, SINGLE_LINE);
+	SinkPrintf(pSink, "VCO2.freq:\t %02Xh\t %4d\n", pPatch->vco[1].freq, pPatch->vco[1].freq);
+	SinkPrintf(pSink, "VCO2.detune:\t %02Xh\t %4d\n", pPatch->vco[1].detune, pPatch->vco[1].detune);
+	SinkPrintf(pSink, "VCO2.pw:\t %02Xh\t %4d\n", pPatch->vco[1].pw, pPatch->vco[1].pw);
+	SinkPrintf(pSink, "VCO2.vol:\t %02Xh\t %4d\n", pPatch->vco[1].vol, pPatch->vco[1].vol);
+	SinkPrintf(pSink, "VCO2.mod:\t %02Xh\t %4d : ", pPatch->vco[1].mod, pPatch->vco[1].mod);
+	for (int i = 0; i < 4; i++) {
+		if ((ModulationFlagsNames[i].iNumber & pPatch->vco[1].mod) == ModulationFlagsNames[i].iNumber) {
+			SinkPrintf(pSink, "%s ", ModulationFlagsNames[i].pszString);
+		}
+	}
+	SinkPrintf(pSink, "\n");
+	SinkPrintf(pSink, "VCO2.wave:\t %02Xh\t %4d : ", pPatch->vco[1].wave, pPatch->vco[1].wave);
+	for (int i = 0; i < ::VCOWAVEFLAGS_COUNT; i++) {
+		if ((VCOWavesFlagsNames[i].iNumber & pPatch->vco[1].wave) == VCOWavesFlagsNames[i].iNumber) {
+			SinkPrintf(pSink, "%s ", VCOWavesFlagsNames[i].pszString);
+		}
+	}
+	SinkPrintf(pSink, "\n");
+
+	//VCF ------------------------------------
+	SinkPrintf(pSink, SINGLE_LINE);
+	SinkPrintf(pSink, "VCF.freq:\t %02Xh\t %4d\n", pPatch->vcf.freq, pPatch->vcf.freq);
+	SinkPrintf(pSink, "VCF.res:\t %02Xh\t %4d\n", pPatch->vcf.res, pPatch->vcf.res);
+	SinkPrintf(pSink, "VCF.mode:\t %02Xh\t %4d : %s\n", pPatch->vcf.fmode, pPatch->vcf.fmode, VCFFilterTypesNames[pPatch->vcf.fmode]);
+	SinkPrintf(pSink, "VCF.vca1:\t %02Xh\t %4d\n", pPatch->vcf.vca1, pPatch->vcf.vca1);
+	SinkPrintf(pSink, "VCF.vca2:\t %02Xh\t %4d\n", pPatch->vcf.vca2, pPatch->vcf.vca2);
+	SinkPrintf(pSink, "VCF.mod:\t %02Xh\t %4d : ", pPatch->vcf.mod, pPatch->vcf.mod);
+	for (int i = 0; i < ::MODULATIONFLAGS_COUNT; i++) {
+		if ((ModulationFlagsNames[i].iNumber & pPatch->vcf.mod) == ModulationFlagsNames[i].iNumber) {
+			SinkPrintf(pSink, "%s ", ModulationFlagsNames[i].pszString);
+		}
+	}
+	SinkPrintf(pSink, "\n");
+
+	//FM LAG ------------------------------------
+	SinkPrintf(pSink, SINGLE_LINE);
+
+	SinkPrintf(pSink, "FMLAG.amp\t %02Xh\t %4d\n", pPatch->fm_lag.fm_amp, pPatch->fm_lag.fm_amp);
+	SinkPrintf(pSink, "FMLAG.dest:\t %02Xh\t %4d : %s\n", pPatch->fm_lag.fm_dest, pPatch->fm_lag.fm_dest, FMDestinationTypesNames[pPatch->fm_lag.fm_dest]);
+	SinkPrintf(pSink, "FMLAG.lag_in:\t %02Xh\t %4d : %s\n", pPatch->fm_lag.lag_in, pPatch->fm_lag.lag_in, ModulationSourcesFlagsNames[pPatch->fm_lag.lag_in]);
+	SinkPrintf(pSink, "FMLAG.lag_rate:\t %02Xh\t %4d\n", pPatch->fm_lag.lag_rate, pPatch->fm_lag.lag_rate);
+	SinkPrintf(pSink, "FMLAG.lag_mode:\t %02Xh\t %4d : ", pPatch->fm_lag.lag_mode, pPatch->fm_lag.lag_mode);
+	for (int i = 0; i < ::LAGMODEFLAGS_COUNT; i++) {
+		if ((LagModeFlagsNames[i].iNumber & pPatch->fm_lag.lag_mode) == LagModeFlagsNames[i].iNumber) {
+			SinkPrintf(pSink, "%s ", LagModeFlagsNames[i].pszString);
+		}
+	}
+	SinkPrintf(pSink, "\n");
+
+	//LFO (x5) ------------------------------------
+	for (int i = 0; i < 5; i++) {
+		SinkPrintf(pSink, SINGLE_LINE);
+		SinkPrintf(pSink, "LFO[%01d].speed:\t %02Xh\t %4d\n", i + 1, pPatch->lfo[i].speed, pPatch->lfo[i].speed);
+		SinkPrintf(pSink, "LFO[%01d].trg_mod:\t %02Xh\t %4d : %s\n", i + 1, pPatch->lfo[i].retrig_mode, pPatch->lfo[i].retrig_mode, TriggerTypesNames[pPatch->lfo[i].retrig_mode]);
+		SinkPrintf(pSink, "LFO[%01d].lag:\t %02Xh\t %4d : ", i + 1, pPatch->lfo[i].lag, pPatch->lfo[i].lag);
+		for (int j = 0; j < ::LAGFLAGS_COUNT; j++) {
+			if ((LagFlagsNames[j].iNumber & pPatch->lfo[i].lag) == LagFlagsNames[j].iNumber) {
+				SinkPrintf(pSink, "%s ", LagFlagsNames[j].pszString);
+			}
+		}
+		SinkPrintf(pSink, "\n");
+		SinkPrintf(pSink, "LFO[%01d].wave:\t %02Xh\t %4d : %s\n", i + 1, pPatch->lfo[i].wave, pPatch->lfo[i].wave, WaveTypesNames[pPatch->lfo[i].wave]);
+		SinkPrintf(pSink, "LFO[%01d].retrig:\t %02Xh\t %4d\n", i + 1, pPatch->lfo[i].retrig, pPatch->lfo[i].retrig);
+		SinkPrintf(pSink, "LFO[%01d].sample\t %02Xh\t %4d : %s\n", i + 1, pPatch->lfo[i].sample, pPatch->lfo[i].sample, ModulationSourcesFlagsNames[pPatch->lfo[i].sample]);
+		SinkPrintf(pSink, "LFO[%01d].amp:\t %02Xh\t %4d\n", i + 1, pPatch->lfo[i].amp, pPatch->lfo[i].amp);
+	}
+
+	//ENV (x5) ------------------------------------
+	for (int i = 0; i < 5; i++) {
+		SinkPrintf(pSink, SINGLE_LINE);
+		SinkPrintf(pSink, "ENV[%01d].flags:\t %02Xh\t %4d : ", i + 1, pPatch->env[i].flags, pPatch->env[i].flags);
+
+		for (int j = 0; j < ::ENVELOPPEMODEFLAGS_COUNT; j++) {
+			if ((EnveloppeModeFlagsNames[j].iNumber & pPatch->env[i].flags) == EnveloppeModeFlagsNames[j].iNumber) {
+				SinkPrintf(pSink, "%s ", EnveloppeModeFlagsNames[j].pszString);
+			}
+		}
+		SinkPrintf(pSink, "\n");
+
+		SinkPrintf(pSink, "ENV[%01d].lfo_trg:\t %02Xh\t %4d : %s\n", i + 1, pPatch->env[i].lfotrig, pPatch->env[i].lfotrig, LFOTriggerCodesNames[pPatch->env[i].lfotrig]);
+		SinkPrintf(pSink, "ENV[%01d].delay:\t %02Xh\t %4d\n", i + 1, pPatch->env[i].delay, pPatch->env[i].delay);
+		SinkPrintf(pSink, "ENV[%01d].attck:\t %02Xh\t %4d\n", i + 1, pPatch->env[i].attack, pPatch->env[i].attack);
+		SinkPrintf(pSink, "ENV[%01d].decay:\t %02Xh\t %4d\n", i + 1, pPatch->env[i].decay, pPatch->env[i].decay);
+		SinkPrintf(pSink, "ENV[%01d].sustain:\t %02Xh\t %4d\n", i + 1, pPatch->env[i].sustain, pPatch->env[i].sustain);
+		SinkPrintf(pSink, "ENV[%01d].rel:\t %02Xh\t %4d\n", i + 1, pPatch->env[i].release, pPatch->env[i].release);
+		SinkPrintf(pSink, "ENV[%01d].amp:\t %02Xh\t %4d\n", i + 1, pPatch->env[i].amp, pPatch->env[i].amp);
+	}
+
+	//TRACK (x3) ------------------------------------
+	for (int i = 0; i < 3; i++) {
+		SinkPrintf(pSink, SINGLE_LINE);
+		SinkPrintf(pSink, "TRACK[%01d].input:\t %02Xh\t %4d : %s\n", i + 1, pPatch->track[i].input, pPatch->track[i].input, ModulationSourcesFlagsNames[pPatch->track[i].input]);
+		// track points (x5)
+		SinkPrintf(pSink, "TRACK[%01d].points:\t    ", i + 1);
+		for (int j = 0; j < 5; j++) {
+			if (j < 4) {
+				SinkPrintf(pSink, "%d,", pPatch->track[i].point[j]);
+			}
+			else {
+				SinkPrintf(pSink, "%d", pPatch->track[i].point[j]);
+			}
+		}
+		SinkPrintf(pSink, "\n");
+	}
+
+	// RAMP (x4) ------------------------------------
+	for (int i = 0; i < 4; i++) {
+		SinkPrintf(pSink, SINGLE_LINE);
+		SinkPrintf(pSink, "RAMP[%01d].rate:\t %02Xh\t %4d\n", i + 1, pPatch->ramp[i].rate, pPatch->ramp[i].rate);
+		SinkPrintf(pSink, "RAMP[%01d].flags:\t %02Xh\t %4d : ", i + 1, pPatch->ramp[i].flags, pPatch->ramp[i].flags);
+
+		for (int j = 0; j < ::RAMPFLAGS_COUNT; j++) {
+			if ((RampFlagsNames[j].iNumber & pPatch->ramp[i].flags) == RampFlagsNames[j].iNumber) {
+				SinkPrintf(pSink, "%s ", RampFlagsNames[j].pszString);
+			}
+		}
+		SinkPrintf(pSink, "\n");
+
+		SinkPrintf(pSink, "RAMP[%01d].lfotrg:\t %02Xh\t %4d : %s\n", i + 1, pPatch->ramp[i].lfotrig, pPatch->ramp[i].lfotrig, LFOTriggerCodesNames[pPatch->ramp[i].lfotrig]);
+	}
+
+	// MOD MATRIX (x20) ------------------------------------
+	for (int i = 0; i < ::MODULATION_MAX_ENTRIES; i++) {
+		SinkPrintf(pSink, SINGLE_LINE);
+
+		// seems that unused modulations entries are garbage
+		unsigned char source = pPatch->mod[i].source;
+		unsigned char dest = pPatch->mod[i].dest;
+		if (source >= MODULATION_SOURCE_COUNT || dest >= MODULATION_DEST_COUNT) {
+			SinkPrintf(pSink, "MOD[%02d]: UNUSED ENTRY\n", i + 1);
+		}
+
+		else {
+			// get the 6 bits unsigned value
+			char amount = (char)pPatch->mod[i].amountSignAndQuantize & MODULATION_VALUE_MASK;
+			// sign bit
+			if ((pPatch->mod[i].amountSignAndQuantize & MODULATION_SIGN_MASK) == MODULATION_SIGN_MASK) {
+				amount *= -1;
+			}
+			// quantize bit
+			const char* pszQuantized;
+			if ((pPatch->mod[i].amountSignAndQuantize & MODULATION_QTZ_MASK) == MODULATION_QTZ_MASK) {
+				pszQuantized = "[Q]";
+			}
+			else {
+				pszQuantized = "";
+			}
+			SinkPrintf(pSink, "MOD[%02d]: %s modulates %s, amount:%d %s\n", i + 1,
+				ModulationSourcesFlagsNames[pPatch->mod[i].source],
+				ModulationDestinationsTypesNames[pPatch->mod[i].dest],
+				amount, pszQuantized);
+		}
+	}
+}
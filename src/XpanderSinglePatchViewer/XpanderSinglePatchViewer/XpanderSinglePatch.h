@@ -0,0 +1,151 @@
+//This file is part of XpanderSinglePatchViewer
+
+//XpanderSinglePatchViewer is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//XpanderSinglePatchViewer is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with XpanderSinglePatchViewer.
+//If not, see <http://www.gnu.org/licenses/>.
+
+//============================================================================
+// Single patch sysex decoding and human-readable dump
+//============================================================================
+
+#ifndef _XPANDERSINGLEPATCH__
+#define _XPANDERSINGLEPATCH__
+
+#include <stdio.h>
+#include <stddef.h>
+
+#include "XpanderSysEx.h"
+#include "XpanderOutputSink.h"
+
+//----------------------------------------------------------------------------
+/*! Check if some bytes are a single patch data intro
+@param [in] pIntro: at least PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH bytes
+@return true if the bytes start with F0 10 02 01 00
+*/
+bool IsSinglePatchIntro(const unsigned char* pIntro);
+
+//----------------------------------------------------------------------------
+/*! Locate a single patch sysex data from the specified file
+@param [in] pFile: the opened file to get data from
+@return true is single patch data found, else false.
+@remark when data are found, current file position is set to the
+beginning of the data and the patch header is written to stdout.
+*/
+bool LocateSinglePatchData(FILE* pFile);
+
+//----------------------------------------------------------------------------
+/*! Locate a complete single patch sysex message in a memory buffer
+@param [in] pData: the buffer to search
+@param [in] size: size of the buffer in bytes
+@param [in] from: offset to start the search at
+@return offset of the F0 byte of the message, or size if none found
+*/
+size_t FindSinglePatchData(const unsigned char* pData, size_t size, size_t from);
+
+//----------------------------------------------------------------------------
+// Streaming single patch scanner: data can be fed in chunks of any size, a
+// message split between two chunks is completed by the next one. The
+// scanner state can be kept to resume scanning when more data comes.
+// A message is only reported once its EOX is read: a status byte before it
+// means the message was cut, the search starts again at that byte.
+typedef struct _SinglePatchScanner {
+	unsigned char message[PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH + SINGLE_PATCH_DATA_LENGTH];
+	int messageLength;					// bytes of the current message collected so far
+	unsigned long long messageOffset;	// stream offset of the current message
+	unsigned long long position;		// stream offset of the next byte to feed
+	unsigned long long truncatedCount;	// single patch messages cut before their EOX
+} SinglePatchScanner;
+
+/*! Called for each complete single patch found by the scanner
+@param [in] pUser: the scanner user data
+@param [in] offset: stream offset of the F0 byte of the message
+@param [in] pIntro: the PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH bytes intro, followed by
+the raw data of the message (all but the EOX, which was checked)
+@param [in] pPatch: the repacked patch
+*/
+typedef void (*SinglePatchCallback)(void* pUser, unsigned long long offset, const unsigned char* pIntro, const SinglePatch* pPatch);
+
+//----------------------------------------------------------------------------
+/*! Initialize a scanner at the beginning of a stream
+@param [out] pScanner: the scanner to initialize
+*/
+void InitSinglePatchScanner(SinglePatchScanner* pScanner);
+
+//----------------------------------------------------------------------------
+/*! Feed the next bytes of the stream to a scanner
+@param [in] pScanner: the scanner
+@param [in] pData: the next bytes of the stream
+@param [in] size: number of bytes
+@param [in] pCallback: called for each complete single patch
+@param [in] pUser: passed to the callback
+*/
+void FeedSinglePatchScanner(SinglePatchScanner* pScanner, const unsigned char* pData, size_t size,
+	SinglePatchCallback pCallback, void* pUser);
+
+//----------------------------------------------------------------------------
+/*! End of the stream: a single patch message still open is counted as truncated
+@param [in] pScanner: the scanner
+*/
+void EndSinglePatchScanner(SinglePatchScanner* pScanner);
+
+//----------------------------------------------------------------------------
+/*! Read the the single patch data from file to a SinglePatch struct
+@remark: assumes that the file current position is at the beginning of the data
+@param [in] pFile: file to read data from
+@param [out] pPatch: the single patch data struct
+*/
+void ReadSinglePatchData(FILE* pFile, SinglePatch* pPatch);
+
+//----------------------------------------------------------------------------
+/*! Repack raw single patch data to a SinglePatch struct
+@param [in] pData: SINGLE_PATCH_DATA_LENGTH bytes following the intro
+@param [out] pPatch: the single patch data struct
+*/
+void RepackSinglePatchData(const unsigned char* pData, SinglePatch* pPatch);
+
+//----------------------------------------------------------------------------
+/*! Encode a SinglePatch struct to a complete single patch sysex message,
+reverse of RepackSinglePatchData()
+@param [in] pPatch: the single patch data struct
+@param [in] programNumber: program number of the message (0 to 99)
+@param [out] pMessage: SINGLE_PATCH_SYSEX_LENGTH bytes
+*/
+void EncodeSinglePatchData(const SinglePatch* pPatch, unsigned char programNumber, unsigned char* pMessage);
+
+//----------------------------------------------------------------------------
+/*! Check that the enum values of a patch are in range, i.e. the patch can be
+given to DumpPatch()
+@param [in] pPatch: the patch to check
+@return false if an enum value (filter type, FM destination, modulation
+sources, trigger types, LFO waves, LFO trigger codes) is out of range
+@remark out of range modulation entries are unused entries, thus valid, unless
+their source or destination is 80h or more.
+*/
+bool IsSinglePatchDumpable(const SinglePatch* pPatch);
+
+//----------------------------------------------------------------------------
+/*! Write the program type and number of a single patch message
+@param [in] pIntro: the PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH bytes intro, followed by
+the raw data of the message (all but the EOX)
+@param [in] pSink: where to write to
+*/
+void DumpPatchHeader(const unsigned char* pIntro, OutputSink* pSink);
+
+//----------------------------------------------------------------------------
+/*! Dump a SinglePatch struct with human-readable informations
+@param [in] pPatch: the patch to dump
+@param [in] pSink: where to write to
+*/
+void DumpPatch(const SinglePatch* pPatch, OutputSink* pSink);
+
+#endif // _XPANDERSINGLEPATCH__
@@ -24,7 +24,28 @@
 // Latest version of this source code can be found here:
 // https://github.com/xplorer2716/OberheimXpanderMidiSpec
 //============================================================================
-// CURRENT VERSION IS: 1.2
+// CURRENT VERSION IS: 1.3
+//
+// 1.3
+// - decoding and dump moved to XpanderSinglePatch.cpp, dump can be written
+//   to a memory buffer
+// - reusable arena-based decode context for batch decoding (no malloc/free
+//   once initialized)
+// - watch mode (--watch): incremental re-scan of a patch library directory
+// - persistent decode cache (--cache-dir, --cache-size)
+// - patch generation engine (--generate): crossover and mutation of the
+//   patches of a file
+// - system exclusive dispatcher (--classify): all the Oberheim messages of a
+//   capture are classified in a single pass, voice data dumps are decoded
+// - libxpander: decoding as a shared library with a C ABI (../libxpander),
+//   with the LibXpanderBenchmark FFI call overhead benchmark
+// - corpus statistics (--stats, --threads, --stats-csv): value histograms of
+//   all the fields, codes and flags usage, modulation routings frequencies
+// - field projection (--fields): only the selected fields are read from the
+//   mapped file, repacked and dumped
+// - concurrent capture (--capture, --capture-dir, --capture-timeout): several
+//   MIDI inputs or named pipes captured at the same time to timestamped
+//   archives, one thread per device
 //
 // 1.2
 // - fix negative quantized moduluation values
@@ -47,265 +68,549 @@
 
 //Xpander header
 #include "XpanderSysEx.h"
+#include "XpanderSinglePatch.h"
+#include "XpanderWatch.h"
+#include "XpanderDecodeCache.h"
+#include "XpanderDecodeContext.h"
+#include "XpanderPatchGenerator.h"
+#include "XpanderSysExDispatcher.h"
+#include "XpanderPatchStats.h"
+#include "XpanderFieldPlan.h"
+#include "XpanderMappedFile.h"
+#include "XpanderCapture.h"
 
 // utility
 typedef enum _ReturnCodes {
 	RETURN_ERROR = 1,
 	RETURN_OK = 0
 };
-// UI stuff :)
-static const char* SINGLE_LINE = "---------------------------\n";
-static const char* DOUBLE_LINE = "===========================\n";
 
 //----------------------------------------------------------------------------
-/*! Locate a single patch sysex data from the specified file
-@param [in] pFile: the opened file to get data from
-@return true is single patch data found, else false.
-@remark when data are found, current file position is set to the
-beginning of the data.
+/*! Watch mode callback: print an update of the patch library to stdout
 */
-bool LocateSinglePatchData(FILE* pFile) {
-	bool bSinglePatchDataFound = false;
-	bool bEndOfFile = false;
-
-	unsigned char intro[PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH];
-
-	while (!bSinglePatchDataFound && !bEndOfFile) {
-		memset(intro, 0, PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH);
-		// try to identify Single Patch data: F0 10 02 01 00...
-		int nbBytesRead = fread(intro, sizeof(char), PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH, pFile);
-		if (nbBytesRead != PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH) { bEndOfFile = true; break; }
-		if ((intro[0] == 0xF0) && (intro[1] == 0x10) && (intro[2] == 0x02) && (intro[3] == 0x01) && (intro[4] == 0x00)) {
-			// bingo...
-			fprintf(stdout, DOUBLE_LINE);
-			fprintf(stdout, "Program type:\t %02Xh\nProgram number:\t %02Xh (%02d)\n", intro[4], intro[5], intro[5]);
-			{bSinglePatchDataFound = true; break; }
-		}
-		else {
-			// try one byte after beginning...
-			fseek(pFile, -(PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH - 1), SEEK_CUR);
-		}
+static void PrintPatchUpdate(void* pUser, const PatchUpdate* pUpdate) {
+	fprintf(stdout, "%s\t%s\t%llu\t%02d\t%S\n", PatchUpdateKindsNames[pUpdate->kind], pUpdate->pszFileName,
+		pUpdate->offset, pUpdate->programNumber, &pUpdate->pPatch->name);
+	fflush(stdout);
+}
+
+//----------------------------------------------------------------------------
+/*! Watch mode: print the patches of a directory, then their updates
+@param [in] pszDirectory: the patch library directory
+@return RETURN_ERROR when the directory can not be watched
+*/
+static int WatchPatchLibrary(const char* pszDirectory) {
+	PatchLibraryWatch watch;
+	if (!InitPatchLibraryWatch(&watch, pszDirectory, PrintPatchUpdate, NULL)) {
+		fprintf(stderr, "Incorrect directory name!\n");
+		return RETURN_ERROR;
+	}
+	if (!RunPatchLibraryWatch(&watch)) {
+		fprintf(stderr, "Cannot watch directory %s!\n", pszDirectory);
+	}
+	ReleasePatchLibraryWatch(&watch);
+	return RETURN_ERROR;
+}
+
+//----------------------------------------------------------------------------
+/*! Dump the single patches of a file using a persistent decode cache
+@param [in] pszCacheDirectory: the cache directory
+@param [in] cacheMaxSize: size limit of the cache directory in bytes
+@param [in] pszFileName: the sysex file
+@return RETURN_OK if at least one single patch was dumped
+*/
+static int DumpFileCached(const char* pszCacheDirectory, unsigned long long cacheMaxSize, const char* pszFileName) {
+	DecodeCache cache;
+	if (!InitDecodeCache(&cache, pszCacheDirectory, cacheMaxSize)) {
+		fprintf(stderr, "Incorrect cache directory name!\n");
+		return RETURN_ERROR;
+	}
+	DecodedFile decoded;
+	bool bCacheHit = false;
+	if (!DecodeFileCached(&cache, pszFileName, &decoded, &bCacheHit)) {
+		fprintf(stderr, "Incorrect file name!\n");
+		return RETURN_ERROR;
+	}
+
+	OutputSink sink;
+	InitFileSink(&sink, stdout);
+	unsigned char intro[PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH] = { 0xF0, 0x10, 0x02, 0x01, 0x00, 0x00 };
+	for (int i = 0; i < decoded.patchCount; i++) {
+		intro[5] = decoded.pProgramNumbers[i];
+		DumpPatchHeader(intro, &sink);
+		DumpPatch(&decoded.pPatches[i], &sink);
 	}
 
-	return (!bEndOfFile);
+	int patchCount = decoded.patchCount;
+	ReleaseDecodedFile(&decoded);
+	if (patchCount == 0) {
+		fprintf(stderr, "NO single patch data found!\n");
+		return RETURN_ERROR;
+	}
+	return RETURN_OK;
 }
 
+// generation mode output formats
+typedef enum _GenerateOutputFormats {
+	GENERATE_OUTPUT_SYSEX,	// single patch sysex messages
+	GENERATE_OUTPUT_PACKED	// SinglePatch structs
+} GenerateOutputFormats;
+
+// patches generated and written at once
+static const int GENERATE_BATCH_SIZE = 4096;
+// patches decoded at once when reading the parents
+static const int PARENTS_BATCH_SIZE = 1024;
+
 //----------------------------------------------------------------------------
-/*! Read the the single patch data from file to a SinglePatch struct
-@remark: assumes that the file current position is at the beginning of the data
-@param [in] pFile: file to read data from
-@param [out] pPatch: the single patch data struct
+/*! Read all the single patches of a file
+@param [in] pszFileName: the sysex file
+@param [out] ppPatches: the patches, to be freed by the caller
+@return number of patches read, -1 if the file can not be read
 */
-void ReadSinglePatchData(FILE* pFile, SinglePatch* pPatch) {
-	//  data in sysex are double bytes values (short)
-	unsigned short shortArray[OBWORDS_DATA_LENGTH];
-	memset(shortArray, 0, OBWORDS_DATA_LENGTH);
+static int ReadAllSinglePatches(const char* pszFileName, SinglePatch** ppPatches) {
+	*ppPatches = NULL;
 
-	int iReadBytes = 0;
-	iReadBytes = fread(shortArray, sizeof(short), OBWORDS_DATA_LENGTH, pFile);
+	FILE* pFile = NULL;
+	fopen_s(&pFile, pszFileName, "rb");
+	if (pFile == NULL) {
+		return -1;
+	}
+	fseek(pFile, 0, SEEK_END);
+	long fileSize = ftell(pFile);
+	fseek(pFile, 0, SEEK_SET);
+	unsigned char* pData = (unsigned char*)malloc(fileSize > 0 ? fileSize : 1);
+	if (pData == NULL || fread(pData, 1, fileSize, pFile) != (size_t)fileSize) {
+		free(pData);
+		fclose(pFile);
+		return -1;
+	}
+	fclose(pFile);
 
-	assert(iReadBytes == OBWORDS_DATA_LENGTH);
+	// DecodeBatch() does not require the EOX: at most one patch per
+	// SINGLE_PATCH_SYSEX_LENGTH - 1 bytes
+	int maxPatches = (int)(fileSize / (SINGLE_PATCH_SYSEX_LENGTH - 1));
+	DecodeContext context;
+	*ppPatches = (SinglePatch*)malloc((maxPatches > 0 ? maxPatches : 1) * sizeof(SinglePatch));
+	if (*ppPatches == NULL || !DecodeContextInit(&context, PARENTS_BATCH_SIZE, PARENTS_BATCH_SIZE * (PATCHNAME_LENGTH + 8))) {
+		free(*ppPatches);
+		*ppPatches = NULL;
+		free(pData);
+		return -1;
+	}
 
-	// for each double byte, repack the value, and set the Patch property accordingly
-	unsigned char* pByte = (unsigned char*)pPatch;
-	for (int i = 0; i < OBWORDS_DATA_LENGTH; i++) {
-		// 8th bit of the 8 bits value is the first bit of the high byte
-		unsigned char cValue = ((shortArray[i] & 0x100) >> 1) | (shortArray[i] & 0x0ff);
-		*pByte = cValue;
-		pByte++;
+	int patchCount = 0;
+	size_t offset = 0;
+	while (offset < (size_t)fileSize) {
+		DecodeContextReset(&context);
+		offset = DecodeBatch(&context, pData, fileSize, offset, DECODE_FLAG_NONE);
+		for (int i = 0; i < context.patchCount && patchCount < maxPatches; i++) {
+			(*ppPatches)[patchCount++] = context.pPatches[i].patch;
+		}
 	}
 
-	// name is 2 bytes/char, high byte never used, thus wchar_t compatible
-	iReadBytes = 0;
-	iReadBytes = fread(&pPatch->name, sizeof(wchar_t), PATCHNAME_LENGTH, pFile);
-	assert(iReadBytes == PATCHNAME_LENGTH);
+	DecodeContextRelease(&context);
+	free(pData);
+	return patchCount;
 }
+
 //----------------------------------------------------------------------------
-/*! Dump a SinglePatch struct to the stdout with human-readable informations
-@param [in] pPatch: the patch to dump
+/*! Generation mode: write new patches bred from the patches of a file
+@param [in] pszFileName: the sysex file giving the parent patches
+@param [in] pszOutputFileName: the file to write the generated patches to
+@param [in] format: GENERATE_OUTPUT_xxx
+@param [in] count: number of patches to generate
+@param [in] seed: PRNG seed
+@param [in] mutationRate: mutation probability of each field
+@param [in] crossoverRate: crossover probability of each patch
+@return RETURN_OK if all the patches were written
+@remark the generation and encoding throughput is written to stderr.
 */
-void DumpPatch(const SinglePatch* pPatch) {
-	// NAME ------------------------------------
-	fprintf(stdout, "NAME:\t%S\n", &pPatch->name);
-
-	// VCO1  ------------------------------------
-	fprintf(stdout, SINGLE_LINE);
-	fprintf(stdout, "VCO1.freq:\t %02Xh\t %4d\n", pPatch->vco[0].freq, pPatch->vco[0].freq);
-	fprintf(stdout, "VCO1.detune:\t %02Xh\t %4d\n", pPatch->vco[0].detune, pPatch->vco[0].detune);
-	fprintf(stdout, "VCO1.pw:\t %02Xh\t %4d\n", pPatch->vco[0].pw, pPatch->vco[0].pw);
-	fprintf(stdout, "VCO1.vol:\t %02Xh\t %4d\n", pPatch->vco[0].vol, pPatch->vco[0].vol);
-	fprintf(stdout, "VCO1.mod:\t %02Xh\t %4d : ", pPatch->vco[0].mod, pPatch->vco[0].mod);
-	// show bitfields
-	for (int i = 0; i < ::MODULATIONFLAGS_COUNT; i++) {
-		if ((ModulationFlagsNames[i].iNumber & pPatch->vco[0].mod) == ModulationFlagsNames[i].iNumber) {
-			fprintf(stdout, "%s ", ModulationFlagsNames[i].pszString);
-		}
-	}
-	fprintf(stdout, "\n");
-	fprintf(stdout, "VCO1.wave:\t %02Xh\t %4d : ", pPatch->vco[0].wave, pPatch->vco[0].wave);
-	for (int i = 0; i < ::VCOWAVEFLAGS_COUNT; i++) {
-		if ((VCOWavesFlagsNames[i].iNumber & pPatch->vco[0].wave) == VCOWavesFlagsNames[i].iNumber) {
-			fprintf(stdout, "%s ", VCOWavesFlagsNames[i].pszString);
-		}
-	}
-	fprintf(stdout, "\n");
-
-	//VCO2 ------------------------------------
-	fprintf(stdout, SINGLE_LINE);
-	fprintf(stdout, "VCO2.freq:\t %02Xh\t %4d\n", pPatch->vco[1].freq, pPatch->vco[1].freq);
-	fprintf(stdout, "VCO2.detune:\t %02Xh\t %4d\n", pPatch->vco[1].detune, pPatch->vco[1].detune);
-	fprintf(stdout, "VCO2.pw:\t %02Xh\t %4d\n", pPatch->vco[1].pw, pPatch->vco[1].pw);
-	fprintf(stdout, "VCO2.vol:\t %02Xh\t %4d\n", pPatch->vco[1].vol, pPatch->vco[1].vol);
-	fprintf(stdout, "VCO2.mod:\t %02Xh\t %4d : ", pPatch->vco[1].mod, pPatch->vco[1].mod);
-	for (int i = 0; i < 4; i++) {
-		if ((ModulationFlagsNames[i].iNumber & pPatch->vco[1].mod) == ModulationFlagsNames[i].iNumber) {
-			fprintf(stdout, "%s ", ModulationFlagsNames[i].pszString);
-		}
-	}
-	fprintf(stdout, "\n");
-	fprintf(stdout, "VCO2.wave:\t %02Xh\t %4d : ", pPatch->vco[1].wave, pPatch->vco[1].wave);
-	for (int i = 0; i < ::VCOWAVEFLAGS_COUNT; i++) {
-		if ((VCOWavesFlagsNames[i].iNumber & pPatch->vco[1].wave) == VCOWavesFlagsNames[i].iNumber) {
-			fprintf(stdout, "%s ", VCOWavesFlagsNames[i].pszString);
-		}
-	}
-	fprintf(stdout, "\n");
-
-	//VCF ------------------------------------
-	fprintf(stdout, SINGLE_LINE);
-	fprintf(stdout, "VCF.freq:\t %02Xh\t %4d\n", pPatch->vcf.freq, pPatch->vcf.freq);
-	fprintf(stdout, "VCF.res:\t %02Xh\t %4d\n", pPatch->vcf.res, pPatch->vcf.res);
-	fprintf(stdout, "VCF.mode:\t %02Xh\t %4d : %s\n", pPatch->vcf.fmode, pPatch->vcf.fmode, VCFFilterTypesNames[pPatch->vcf.fmode]);
-	fprintf(stdout, "VCF.vca1:\t %02Xh\t %4d\n", pPatch->vcf.vca1, pPatch->vcf.vca1);
-	fprintf(stdout, "VCF.vca2:\t %02Xh\t %4d\n", pPatch->vcf.vca2, pPatch->vcf.vca2);
-	fprintf(stdout, "VCF.mod:\t %02Xh\t %4d : ", pPatch->vcf.mod, pPatch->vcf.mod);
-	for (int i = 0; i < ::MODULATIONFLAGS_COUNT; i++) {
-		if ((ModulationFlagsNames[i].iNumber & pPatch->vcf.mod) == ModulationFlagsNames[i].iNumber) {
-			fprintf(stdout, "%s ", ModulationFlagsNames[i].pszString);
-		}
-	}
-	fprintf(stdout, "\n");
-
-	//FM LAG ------------------------------------
-	fprintf(stdout, SINGLE_LINE);
-
-	fprintf(stdout, "FMLAG.amp\t %02Xh\t %4d\n", pPatch->fm_lag.fm_amp, pPatch->fm_lag.fm_amp);
-	fprintf(stdout, "FMLAG.dest:\t %02Xh\t %4d : %s\n", pPatch->fm_lag.fm_dest, pPatch->fm_lag.fm_dest, FMDestinationTypesNames[pPatch->fm_lag.fm_dest]);
-	fprintf(stdout, "FMLAG.lag_in:\t %02Xh\t %4d : %s\n", pPatch->fm_lag.lag_in, pPatch->fm_lag.lag_in, ModulationSourcesFlagsNames[pPatch->fm_lag.lag_in]);
-	fprintf(stdout, "FMLAG.lag_rate:\t %02Xh\t %4d\n", pPatch->fm_lag.lag_rate, pPatch->fm_lag.lag_rate);
-	fprintf(stdout, "FMLAG.lag_mode:\t %02Xh\t %4d : ", pPatch->fm_lag.lag_mode, pPatch->fm_lag.lag_mode);
-	for (int i = 0; i < ::LAGMODEFLAGS_COUNT; i++) {
-		if ((LagModeFlagsNames[i].iNumber & pPatch->fm_lag.lag_mode) == LagModeFlagsNames[i].iNumber) {
-			fprintf(stdout, "%s ", LagModeFlagsNames[i].pszString);
-		}
-	}
-	fprintf(stdout, "\n");
-
-	//LFO (x5) ------------------------------------
-	for (int i = 0; i < 5; i++) {
-		fprintf(stdout, SINGLE_LINE);
-		fprintf(stdout, "LFO[%01d].speed:\t %02Xh\t %4d\n", i + 1, pPatch->lfo[i].speed, pPatch->lfo[i].speed);
-		fprintf(stdout, "LFO[%01d].trg_mod:\t %02Xh\t %4d : %s\n", i + 1, pPatch->lfo[i].retrig_mode, pPatch->lfo[i].retrig_mode, TriggerTypesNames[pPatch->lfo[i].retrig_mode]);
-		fprintf(stdout, "LFO[%01d].lag:\t %02Xh\t %4d : ", i + 1, pPatch->lfo[i].lag, pPatch->lfo[i].lag);
-		for (int j = 0; j < ::LAGFLAGS_COUNT; j++) {
-			if ((LagFlagsNames[j].iNumber & pPatch->lfo[i].lag) == LagFlagsNames[j].iNumber) {
-				fprintf(stdout, "%s ", LagFlagsNames[j].pszString);
-			}
-		}
-		fprintf(stdout, "\n");
-		fprintf(stdout, "LFO[%01d].wave:\t %02Xh\t %4d : %s\n", i + 1, pPatch->lfo[i].wave, pPatch->lfo[i].wave, WaveTypesNames[pPatch->lfo[i].wave]);
-		fprintf(stdout, "LFO[%01d].retrig:\t %02Xh\t %4d\n", i + 1, pPatch->lfo[i].retrig, pPatch->lfo[i].retrig);
-		fprintf(stdout, "LFO[%01d].sample\t %02Xh\t %4d : %s\n", i + 1, pPatch->lfo[i].sample, pPatch->lfo[i].sample, ModulationSourcesFlagsNames[pPatch->lfo[i].sample]);
-		fprintf(stdout, "LFO[%01d].amp:\t %02Xh\t %4d\n", i + 1, pPatch->lfo[i].amp, pPatch->lfo[i].amp);
+static int GeneratePatchFile(const char* pszFileName, const char* pszOutputFileName, GenerateOutputFormats format,
+	unsigned long long count, unsigned int seed, double mutationRate, double crossoverRate) {
+	SinglePatch* pParents = NULL;
+	int parentCount = ReadAllSinglePatches(pszFileName, &pParents);
+	if (parentCount < 0) {
+		fprintf(stderr, "Incorrect file name!\n");
+		return RETURN_ERROR;
+	}
+	if (parentCount == 0) {
+		free(pParents);
+		fprintf(stderr, "NO single patch data found!\n");
+		return RETURN_ERROR;
 	}
 
-	//ENV (x5) ------------------------------------
-	for (int i = 0; i < 5; i++) {
-		fprintf(stdout, SINGLE_LINE);
-		fprintf(stdout, "ENV[%01d].flags:\t %02Xh\t %4d : ", i + 1, pPatch->env[i].flags, pPatch->env[i].flags);
+	PatchGenerator generator;
+	bool bInitialized = InitPatchGenerator(&generator, pParents, parentCount, seed);
+	free(pParents);
+	SinglePatch* pPatches = (SinglePatch*)malloc(GENERATE_BATCH_SIZE * sizeof(SinglePatch));
+	unsigned char* pMessages = (unsigned char*)malloc(GENERATE_BATCH_SIZE * SINGLE_PATCH_SYSEX_LENGTH);
+	if (!bInitialized || pPatches == NULL || pMessages == NULL) {
+		fprintf(stderr, "Not enough memory!\n");
+		free(pPatches);
+		free(pMessages);
+		ReleasePatchGenerator(&generator);
+		return RETURN_ERROR;
+	}
+	SetMutationRate(&generator, 0, OBWORDS_DATA_LENGTH, mutationRate);
+	SetCrossoverRate(&generator, crossoverRate);
+
+	FILE* pOutputFile = NULL;
+	fopen_s(&pOutputFile, pszOutputFileName, "wb");
+	if (pOutputFile == NULL) {
+		fprintf(stderr, "Incorrect output file name!\n");
+		free(pPatches);
+		free(pMessages);
+		ReleasePatchGenerator(&generator);
+		return RETURN_ERROR;
+	}
 
-		for (int j = 0; j < ::ENVELOPPEMODEFLAGS_COUNT; j++) {
-			if ((EnveloppeModeFlagsNames[j].iNumber & pPatch->env[i].flags) == EnveloppeModeFlagsNames[j].iNumber) {
-				fprintf(stdout, "%s ", EnveloppeModeFlagsNames[j].pszString);
+	LARGE_INTEGER frequency, start, end;
+	LONGLONG generateTicks = 0;
+	LONGLONG encodeTicks = 0;
+	QueryPerformanceFrequency(&frequency);
+
+	int iResult = RETURN_OK;
+	for (unsigned long long n = 0; n < count; n += GENERATE_BATCH_SIZE) {
+		int batchCount = (count - n < (unsigned long long)GENERATE_BATCH_SIZE) ? (int)(count - n) : GENERATE_BATCH_SIZE;
+
+		QueryPerformanceCounter(&start);
+		GeneratePatches(&generator, pPatches, batchCount);
+		QueryPerformanceCounter(&end);
+		generateTicks += end.QuadPart - start.QuadPart;
+
+		const void* pOutput = pPatches;
+		size_t outputSize = batchCount * sizeof(SinglePatch);
+		if (format == GENERATE_OUTPUT_SYSEX) {
+			QueryPerformanceCounter(&start);
+			for (int i = 0; i < batchCount; i++) {
+				EncodeSinglePatchData(&pPatches[i], (unsigned char)((n + i) % 100), pMessages + i * SINGLE_PATCH_SYSEX_LENGTH);
 			}
+			QueryPerformanceCounter(&end);
+			encodeTicks += end.QuadPart - start.QuadPart;
+			pOutput = pMessages;
+			outputSize = batchCount * SINGLE_PATCH_SYSEX_LENGTH;
 		}
-		fprintf(stdout, "\n");
-
-		fprintf(stdout, "ENV[%01d].lfo_trg:\t %02Xh\t %4d : %s\n", i + 1, pPatch->env[i].lfotrig, pPatch->env[i].lfotrig, LFOTriggerCodesNames[pPatch->env[i].lfotrig]);
-		fprintf(stdout, "ENV[%01d].delay:\t %02Xh\t %4d\n", i + 1, pPatch->env[i].delay, pPatch->env[i].delay);
-		fprintf(stdout, "ENV[%01d].attck:\t %02Xh\t %4d\n", i + 1, pPatch->env[i].attack, pPatch->env[i].attack);
-		fprintf(stdout, "ENV[%01d].decay:\t %02Xh\t %4d\n", i + 1, pPatch->env[i].decay, pPatch->env[i].decay);
-		fprintf(stdout, "ENV[%01d].sustain:\t %02Xh\t %4d\n", i + 1, pPatch->env[i].sustain, pPatch->env[i].sustain);
-		fprintf(stdout, "ENV[%01d].rel:\t %02Xh\t %4d\n", i + 1, pPatch->env[i].release, pPatch->env[i].release);
-		fprintf(stdout, "ENV[%01d].amp:\t %02Xh\t %4d\n", i + 1, pPatch->env[i].amp, pPatch->env[i].amp);
-	}
-
-	//TRACK (x3) ------------------------------------
-	for (int i = 0; i < 3; i++) {
-		fprintf(stdout, SINGLE_LINE);
-		fprintf(stdout, "TRACK[%01d].input:\t %02Xh\t %4d : %s\n", i + 1, pPatch->track[i].input, pPatch->track[i].input, ModulationSourcesFlagsNames[pPatch->track[i].input]);
-		// track points (x5)
-		fprintf(stdout, "TRACK[%01d].points:\t    ", i + 1);
-		for (int j = 0; j < 5; j++) {
-			if (j < 4) {
-				fprintf(stdout, "%d,", pPatch->track[i].point[j]);
-			}
-			else {
-				fprintf(stdout, "%d", pPatch->track[i].point[j]);
-			}
+
+		if (fwrite(pOutput, 1, outputSize, pOutputFile) != outputSize) {
+			fprintf(stderr, "Cannot write to %s!\n", pszOutputFileName);
+			iResult = RETURN_ERROR;
+			break;
 		}
-		fprintf(stdout, "\n");
 	}
+	fclose(pOutputFile);
+
+	double generateSeconds = (double)generateTicks / frequency.QuadPart;
+	double encodeSeconds = (double)encodeTicks / frequency.QuadPart;
+	fprintf(stderr, "Generated %llu patches from %d parents in %.3f s (%.0f patches/s)\n", count, parentCount,
+		generateSeconds, (generateSeconds > 0.0) ? count / generateSeconds : 0.0);
+	if (format == GENERATE_OUTPUT_SYSEX) {
+		fprintf(stderr, "Encoded %llu patches in %.3f s (%.0f patches/s)\n", count,
+			encodeSeconds, (encodeSeconds > 0.0) ? count / encodeSeconds : 0.0);
+	}
+
+	free(pPatches);
+	free(pMessages);
+	ReleasePatchGenerator(&generator);
+	return iResult;
+}
+
+//----------------------------------------------------------------------------
+/*! Classify mode handler: print one line per message
+*/
+static void PrintSysExMessage(void* pUser, const SysExMessage* pMessage) {
+	if (pMessage->bOberheim) {
+		fprintf(stdout, "%llu\t%s\t%02X\t%llu\n", pMessage->offset, GetSysExCommandName(pMessage->command),
+			pMessage->device, (unsigned long long)pMessage->length);
+	}
+	else {
+		fprintf(stdout, "%llu\tSYSEX_%02X\t--\t%llu\n", pMessage->offset, (pMessage->length > 2) ? pMessage->pMessage[1] : 0,
+			(unsigned long long)pMessage->length);
+	}
+}
 
-	// RAMP (x4) ------------------------------------
-	for (int i = 0; i < 4; i++) {
-		fprintf(stdout, SINGLE_LINE);
-		fprintf(stdout, "RAMP[%01d].rate:\t %02Xh\t %4d\n", i + 1, pPatch->ramp[i].rate, pPatch->ramp[i].rate);
-		fprintf(stdout, "RAMP[%01d].flags:\t %02Xh\t %4d : ", i + 1, pPatch->ramp[i].flags, pPatch->ramp[i].flags);
+//----------------------------------------------------------------------------
+/*! Classify mode handler: print and decode program data dumps
+*/
+static void DumpProgramDataMessage(void* pUser, const SysExMessage* pMessage) {
+	PrintSysExMessage(pUser, pMessage);
+	if (pMessage->length == (size_t)SINGLE_PATCH_SYSEX_LENGTH && IsSinglePatchIntro(pMessage->pMessage)) {
+		SinglePatch patch;
+		RepackSinglePatchData(pMessage->pMessage + PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH, &patch);
+		DumpPatchHeader(pMessage->pMessage, (OutputSink*)pUser);
+		DumpPatch(&patch, (OutputSink*)pUser);
+	}
+}
 
-		for (int j = 0; j < ::RAMPFLAGS_COUNT; j++) {
-			if ((RampFlagsNames[j].iNumber & pPatch->ramp[i].flags) == RampFlagsNames[j].iNumber) {
-				fprintf(stdout, "%s ", RampFlagsNames[j].pszString);
+//----------------------------------------------------------------------------
+/*! Classify mode: print all the system exclusive messages of a file, decode
+the single patches, then print the number of messages per command
+@param [in] pszFileName: the capture file
+@return RETURN_OK if at least one Oberheim message was found
+*/
+static int ClassifyFile(const char* pszFileName) {
+	FILE* pFile = NULL;
+	fopen_s(&pFile, pszFileName, "rb");
+	if (pFile == NULL) {
+		fprintf(stderr, "Incorrect file name!\n");
+		return RETURN_ERROR;
+	}
+
+	OutputSink sink;
+	InitFileSink(&sink, stdout);
+	SysExDispatcher dispatcher;
+	InitSysExDispatcher(&dispatcher);
+	SetDefaultSysExHandler(&dispatcher, PrintSysExMessage, NULL);
+	SetSysExHandler(&dispatcher, SYSEXCMD_PRG_DUMP_FOLLOWS, DumpProgramDataMessage, &sink);
+
+	// messages split between two reads are given again with the next bytes,
+	// the dispatcher resumes the search of their end where it stopped
+	static const size_t READ_SIZE = 64 * 1024;
+	unsigned char* pBuffer = NULL;
+	size_t bufferSize = 0;
+	size_t bufferUsed = 0;
+	unsigned long long streamOffset = 0;
+	for (;;) {
+		if (bufferSize - bufferUsed < READ_SIZE) {
+			unsigned char* pNewBuffer = (unsigned char*)realloc(pBuffer, bufferUsed + READ_SIZE);
+			if (pNewBuffer == NULL) {
+				break;
 			}
+			pBuffer = pNewBuffer;
+			bufferSize = bufferUsed + READ_SIZE;
 		}
-		fprintf(stdout, "\n");
+		size_t readSize = fread(pBuffer + bufferUsed, 1, READ_SIZE, pFile);
+		if (readSize == 0) {
+			break;
+		}
+		bufferUsed += readSize;
+		size_t consumed = DispatchSysEx(&dispatcher, pBuffer, bufferUsed, streamOffset);
+		memmove(pBuffer, pBuffer + consumed, bufferUsed - consumed);
+		bufferUsed -= consumed;
+		streamOffset += consumed;
+	}
+	// a message still open at the end of the file
+	EndSysExStream(&dispatcher, bufferUsed);
+	free(pBuffer);
+	fclose(pFile);
 
-		fprintf(stdout, "RAMP[%01d].lfotrg:\t %02Xh\t %4d : %s\n", i + 1, pPatch->ramp[i].lfotrig, pPatch->ramp[i].lfotrig, LFOTriggerCodesNames[pPatch->ramp[i].lfotrig]);
+	unsigned long long oberheimCount = 0;
+	fprintf(stdout, "===========================\n");
+	for (int i = 0; i < SYSEX_COMMAND_MAX_COUNT; i++) {
+		if (dispatcher.commandCounts[i] > 0) {
+			fprintf(stdout, "%02X %-20s: %llu\n", i, GetSysExCommandName((unsigned char)i), dispatcher.commandCounts[i]);
+			oberheimCount += dispatcher.commandCounts[i];
+		}
 	}
+	fprintf(stdout, "Other system exclusive messages: %llu\n", dispatcher.otherCount);
+	fprintf(stdout, "Truncated messages: %llu\n", dispatcher.truncatedCount);
 
-	// MOD MATRIX (x20) ------------------------------------
-	for (int i = 0; i < ::MODULATION_MAX_ENTRIES; i++) {
-		fprintf(stdout, SINGLE_LINE);
+	if (oberheimCount == 0) {
+		fprintf(stderr, "NO Oberheim system exclusive message found!\n");
+		return RETURN_ERROR;
+	}
+	return RETURN_OK;
+}
 
-		// seems that unused modulations entries are garbage
-		char source = pPatch->mod[i].source;
-		char dest = pPatch->mod[i].dest;
-		if (source >= MODULATION_SOURCE_COUNT || dest >= MODULATION_DEST_COUNT) {
-			fprintf(stdout, "MOD[%02d]: UNUSED ENTRY\n", i + 1);
+//----------------------------------------------------------------------------
+/*! Stats mode: count the single patches of a file, or of all the files of a
+directory, print the summary tables and optionally export them as CSV
+@param [in] pszPath: a sysex file or a directory
+@param [in] threadCount: number of counting threads, 0 for one per processor
+@param [in] pszCsvBaseName: CSV files base name, NULL for no export
+@return RETURN_OK if at least one single patch was counted
+*/
+static int ComputeStats(const char* pszPath, int threadCount, const char* pszCsvBaseName) {
+	char** ppszFileNames = NULL;
+	int fileCount = 0;
+	DWORD attributes = GetFileAttributes(pszPath);
+	if (attributes == INVALID_FILE_ATTRIBUTES) {
+		fprintf(stderr, "Incorrect file name!\n");
+		return RETURN_ERROR;
+	}
+	if ((attributes & FILE_ATTRIBUTE_DIRECTORY) == FILE_ATTRIBUTE_DIRECTORY) {
+		char szPattern[MAX_PATH];
+		sprintf_s(szPattern, MAX_PATH, "%s\\*", pszPath);
+		WIN32_FIND_DATA findData;
+		HANDLE hFind = FindFirstFile(szPattern, &findData);
+		if (hFind != INVALID_HANDLE_VALUE) {
+			int fileCapacity = 0;
+			do {
+				if ((findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == FILE_ATTRIBUTE_DIRECTORY) {
+					continue;
+				}
+				if (fileCount == fileCapacity) {
+					fileCapacity = (fileCapacity == 0) ? 64 : fileCapacity * 2;
+					char** ppszNewFileNames = (char**)realloc(ppszFileNames, fileCapacity * sizeof(char*));
+					if (ppszNewFileNames == NULL) {
+						break;
+					}
+					ppszFileNames = ppszNewFileNames;
+				}
+				ppszFileNames[fileCount] = (char*)malloc(MAX_PATH);
+				if (ppszFileNames[fileCount] == NULL) {
+					break;
+				}
+				sprintf_s(ppszFileNames[fileCount], MAX_PATH, "%s\\%s", pszPath, findData.cFileName);
+				fileCount++;
+			} while (FindNextFile(hFind, &findData));
+			FindClose(hFind);
 		}
+	}
+	else {
+		ppszFileNames = (char**)malloc(sizeof(char*));
+		if (ppszFileNames != NULL) {
+			ppszFileNames[0] = _strdup(pszPath);
+			fileCount = (ppszFileNames[0] != NULL) ? 1 : 0;
+		}
+	}
 
-		else {
-			// get the 6 bits unsigned value
-			char amount = (char)pPatch->mod[i].amountSignAndQuantize & MODULATION_VALUE_MASK;
-			// sign bit
-			if ((pPatch->mod[i].amountSignAndQuantize & MODULATION_SIGN_MASK) == MODULATION_SIGN_MASK) {
-				amount *= -1;
-			}
-			// quantize bit
-			const char* pszQuantized;
-			if ((pPatch->mod[i].amountSignAndQuantize & MODULATION_QTZ_MASK) == MODULATION_QTZ_MASK) {
-				pszQuantized = "[Q]";
-			}
-			else {
-				pszQuantized = "";
+	if (threadCount <= 0) {
+		SYSTEM_INFO systemInfo;
+		GetSystemInfo(&systemInfo);
+		threadCount = (int)systemInfo.dwNumberOfProcessors;
+	}
+	// no more threads than files
+	if (threadCount > fileCount) {
+		threadCount = fileCount;
+	}
+
+	PatchStats* pStats = (PatchStats*)malloc(sizeof(PatchStats));
+	int iResult = RETURN_OK;
+	int failedCount = 0;
+	LARGE_INTEGER frequency, start, stop;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&start);
+	if (pStats == NULL || !ComputeCorpusStats(ppszFileNames, fileCount, threadCount, pStats, &failedCount)) {
+		fprintf(stderr, "Can not count the patches!\n");
+		iResult = RETURN_ERROR;
+	}
+	QueryPerformanceCounter(&stop);
+
+	if (iResult == RETURN_OK) {
+		double seconds = (double)(stop.QuadPart - start.QuadPart) / frequency.QuadPart;
+		fprintf(stderr, "Counted %llu patches of %d files (%d unreadable) with %d threads in %.3f s (%.0f patches/s)\n",
+			pStats->patchCount, fileCount, failedCount, threadCount, seconds, (seconds > 0.0) ? pStats->patchCount / seconds : 0.0);
+		if (pStats->patchCount == 0) {
+			fprintf(stderr, "NO single patch data found!\n");
+			iResult = RETURN_ERROR;
+		}
+	}
+	if (iResult == RETURN_OK) {
+		OutputSink sink;
+		InitFileSink(&sink, stdout);
+		PrintPatchStats(pStats, &sink);
+		if (pszCsvBaseName != NULL) {
+			char szFieldsFileName[MAX_PATH];
+			char szRoutingsFileName[MAX_PATH];
+			sprintf_s(szFieldsFileName, MAX_PATH, "%s_fields.csv", pszCsvBaseName);
+			sprintf_s(szRoutingsFileName, MAX_PATH, "%s_routings.csv", pszCsvBaseName);
+			if (!WritePatchStatsCsv(pStats, szFieldsFileName, szRoutingsFileName)) {
+				fprintf(stderr, "Can not write the CSV files!\n");
+				iResult = RETURN_ERROR;
 			}
-			fprintf(stdout, "MOD[%02d]: %s modulates %s, amount:%d %s\n", i + 1,
-				ModulationSourcesFlagsNames[pPatch->mod[i].source],
-				ModulationDestinationsTypesNames[pPatch->mod[i].dest],
-				amount, pszQuantized);
 		}
 	}
+
+	free(pStats);
+	for (int i = 0; i < fileCount; i++) {
+		free(ppszFileNames[i]);
+	}
+	free(ppszFileNames);
+	return iResult;
+}
+
+//----------------------------------------------------------------------------
+/*! Field projection mode: dump the selected fields of each single patch
+@param [in] pszFileName: the sysex file
+@param [in] pPlan: the compiled field selection
+@return RETURN_OK if at least one single patch was dumped
+*/
+static int DumpFileFields(const char* pszFileName, const FieldPlan* pPlan) {
+	MappedFile mapped;
+	if (!MapInputFile(pszFileName, &mapped)) {
+		fprintf(stderr, "Incorrect file name!\n");
+		return RETURN_ERROR;
+	}
+
+	OutputSink sink;
+	InitFileSink(&sink, stdout);
+	SinglePatch patch;
+	memset(&patch, 0, sizeof(SinglePatch));
+	bool bAtLeastOneSinglePatchDataFound = false;
+	// only the intro and the selected double bytes of each message are read
+	size_t offset = FindSinglePatchData(mapped.pData, mapped.size, 0);
+	while (offset < mapped.size) {
+		bAtLeastOneSinglePatchDataFound = true;
+		RepackPlannedFields(pPlan, mapped.pData + offset + PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH, &patch);
+		DumpPatchHeader(mapped.pData + offset, &sink);
+		DumpPlannedFields(pPlan, &patch, &sink);
+		offset = FindSinglePatchData(mapped.pData, mapped.size, offset + SINGLE_PATCH_SYSEX_LENGTH);
+	}
+	UnmapInputFile(&mapped);
+
+	if (!bAtLeastOneSinglePatchDataFound) {
+		fprintf(stderr, "NO single patch data found!\n");
+		return RETURN_ERROR;
+	}
+	return RETURN_OK;
+}
+
+//----------------------------------------------------------------------------
+/*! Capture mode: capture several devices at the same time, then print the
+throughput and latency report
+@param [in] pszSources: comma separated devices, see AddCaptureDevice()
+@param [in] pszDirectory: archives directory
+@param [in] idleTimeout: MIDI inputs idle timeout, in milliseconds
+@return RETURN_OK if at least one single patch was captured
+*/
+static int CaptureDevices(const char* pszSources, const char* pszDirectory, DWORD idleTimeout) {
+	Capture capture;
+	InitCapture(&capture, pszDirectory, idleTimeout);
+
+	int iResult = RETURN_OK;
+	char szSource[MAX_PATH];
+	while (*pszSources != '\0' && iResult == RETURN_OK) {
+		const char* pszEnd = strchr(pszSources, ',');
+		size_t length = (pszEnd != NULL) ? (size_t)(pszEnd - pszSources) : strlen(pszSources);
+		if (length >= MAX_PATH) {
+			length = MAX_PATH - 1;
+		}
+		memcpy(szSource, pszSources, length);
+		szSource[length] = '\0';
+		if (length > 0 && !AddCaptureDevice(&capture, szSource)) {
+			fprintf(stderr, "Can not capture %s!\n", szSource);
+			iResult = RETURN_ERROR;
+		}
+		pszSources += length;
+		if (*pszSources == ',') {
+			pszSources++;
+		}
+	}
+	if (iResult == RETURN_OK) {
+		for (int i = 0; i < capture.deviceCount; i++) {
+			fprintf(stderr, "Capturing %s to %s\n", capture.pDevices[i]->szSource, capture.pDevices[i]->szArchiveFileName);
+		}
+		if (!RunCapture(&capture)) {
+			fprintf(stderr, "Can not start the capture threads!\n");
+			iResult = RETURN_ERROR;
+		}
+		OutputSink sink;
+		InitFileSink(&sink, stdout);
+		PrintCaptureReport(&capture, &sink);
+	}
+
+	unsigned long long patchCount = 0;
+	for (int i = 0; i < capture.deviceCount; i++) {
+		patchCount += capture.pDevices[i]->patchCount;
+	}
+	ReleaseCapture(&capture);
+	if (iResult == RETURN_OK && patchCount == 0) {
+		fprintf(stderr, "NO single patch data found!\n");
+		iResult = RETURN_ERROR;
+	}
+	return iResult;
 }
+
 //----------------------------------------------------------------------------
 /*! Main
 @remarks
@@ -317,6 +622,47 @@ XpanderSinglePatchViewer [your_raw_sysex_file] > [OutputfileName]
 where:
 - [your_raw_sysex_file] is the name of the sysex file
 - [OutputfileName] is the name of the file to write into.
+- watch mode: XpanderSinglePatchViewer --watch [your_patch_library_directory]
+prints one line per single patch of the directory files (ADDED), then one
+line each time a patch is added, removed or changed, until stopped (Ctrl+C).
+Line format is: ADDED|REMOVED|CHANGED<tab>file<tab>offset<tab>program<tab>name
+- decode cache: XpanderSinglePatchViewer --cache-dir [cache_directory]
+[--cache-size [megabytes]] [your_raw_sysex_file]
+the decoded patches are stored in the cache directory (1024 MB by default),
+later runs on a file with the same content skip the decoding.
+- generation mode: XpanderSinglePatchViewer --generate [count] --output [output_file]
+[--output-format sysex|packed] [--seed [n]] [--mutation-rate [0.0-1.0]]
+[--crossover-rate [0.0-1.0]] [your_raw_sysex_file]
+writes count new valid patches bred from the single patches of the sysex
+file, either as single patch sysex messages (default) or as raw SinglePatch
+structs (packed). Default rates are 0.05 (mutation, per field) and 0.5
+(crossover, per patch).
+- classify mode: XpanderSinglePatchViewer --classify [your_capture_file]
+prints one line per system exclusive message of the file:
+offset<tab>command<tab>device<tab>length, voice data dumps are also dumped,
+then the number of messages per command.
+- stats mode: XpanderSinglePatchViewer --stats [your_raw_sysex_file_or_directory]
+[--threads [n]] [--stats-csv [base_name]]
+counts the single patches of the file or of all the directory files (one
+file per thread at a time, one thread per processor by default) and prints
+per field min/max/mean/most frequent value, codes and flags usage and the most
+frequent modulation routings. With --stats-csv, the histograms and routings
+counts are also written to base_name_fields.csv and base_name_routings.csv.
+- field projection: XpanderSinglePatchViewer --fields [patterns] [your_raw_sysex_file]
+dumps only the fields selected by a comma separated list of patterns, e.g.
+--fields name,vcf.*,mod[*] ('*' matches any characters but '.', a pattern
+also selects the sub-fields of the names it matches). Field names are the
+SinglePatch members names, e.g. vcf.fmode, lfo[0].wave, mod[3].dest.
+- capture mode: XpanderSinglePatchViewer --capture [device1,device2,...]
+[--capture-dir [directory]] [--capture-timeout [seconds]]
+captures all the devices at the same time, one thread each. A device is
+midi:[n] for the MIDI input n, or a named pipe (\\.\pipe\[name]) or file
+name. The single patches of each device are written to
+device[i]_[YYYYMMDD_HHMMSS].syx in the directory (current by default), with
+one line per patch in device[i]_[YYYYMMDD_HHMMSS].txt: seconds since the
+start, offset, program, name, status. Pipes are captured until closed by the
+writer, MIDI inputs until they get no data for the timeout (30 s by default).
+Then per device and aggregate throughput and latency are printed.
 */
 int _tmain(int argc, _TCHAR* argv[])
 {
@@ -326,20 +672,148 @@ int _tmain(int argc, _TCHAR* argv[])
 	fprintf(stdout, "Oberheim Xpander/Matrix 12 single patch viewer\n");
 	fprintf(stdout, "The latest version of this utility can be found here: https://github.com/xplorer2716/OberheimXpanderMidiSpec\n");
 
-	// get sysex filename as argument
-	if (argc < 2) {
+	// get options and sysex filename as arguments
+	const char* pszFileName = NULL;
+	const char* pszWatchDirectory = NULL;
+	const char* pszCacheDirectory = NULL;
+	const char* pszClassifyFileName = NULL;
+	const char* pszStatsPath = NULL;
+	const char* pszStatsCsvBaseName = NULL;
+	int threadCount = 0;
+	const char* pszFields = NULL;
+	const char* pszCaptureSources = NULL;
+	const char* pszCaptureDirectory = ".";
+	DWORD captureTimeout = CAPTURE_DEFAULT_IDLE_TIMEOUT;
+	unsigned long long cacheMaxSize = DECODE_CACHE_DEFAULT_MAX_SIZE;
+	unsigned long long generateCount = 0;
+	const char* pszOutputFileName = NULL;
+	GenerateOutputFormats outputFormat = GENERATE_OUTPUT_SYSEX;
+	unsigned int seed = 1;
+	double mutationRate = 0.05;
+	double crossoverRate = 0.5;
+	for (int i = 1; i < argc; i++) {
+		if (strncmp(argv[i], "--", 2) != 0) {
+			pszFileName = argv[i];
+			continue;
+		}
+		if (i + 1 >= argc) {
+			fprintf(stderr, "Please specify a value for option %s!\n", argv[i]);
+			exit(RETURN_ERROR);
+		}
+		if (strcmp(argv[i], "--watch") == 0) {
+			pszWatchDirectory = argv[++i];
+		}
+		else if (strcmp(argv[i], "--cache-dir") == 0) {
+			pszCacheDirectory = argv[++i];
+		}
+		else if (strcmp(argv[i], "--cache-size") == 0) {
+			cacheMaxSize = _strtoui64(argv[++i], NULL, 10) * 1024 * 1024;
+		}
+		else if (strcmp(argv[i], "--classify") == 0) {
+			pszClassifyFileName = argv[++i];
+		}
+		else if (strcmp(argv[i], "--stats") == 0) {
+			pszStatsPath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--threads") == 0) {
+			threadCount = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--stats-csv") == 0) {
+			pszStatsCsvBaseName = argv[++i];
+		}
+		else if (strcmp(argv[i], "--fields") == 0) {
+			pszFields = argv[++i];
+		}
+		else if (strcmp(argv[i], "--capture") == 0) {
+			pszCaptureSources = argv[++i];
+		}
+		else if (strcmp(argv[i], "--capture-dir") == 0) {
+			pszCaptureDirectory = argv[++i];
+		}
+		else if (strcmp(argv[i], "--capture-timeout") == 0) {
+			captureTimeout = strtoul(argv[++i], NULL, 10) * 1000;
+		}
+		else if (strcmp(argv[i], "--generate") == 0) {
+			generateCount = _strtoui64(argv[++i], NULL, 10);
+		}
+		else if (strcmp(argv[i], "--output") == 0) {
+			pszOutputFileName = argv[++i];
+		}
+		else if (strcmp(argv[i], "--output-format") == 0) {
+			i++;
+			if (strcmp(argv[i], "sysex") == 0) {
+				outputFormat = GENERATE_OUTPUT_SYSEX;
+			}
+			else if (strcmp(argv[i], "packed") == 0) {
+				outputFormat = GENERATE_OUTPUT_PACKED;
+			}
+			else {
+				fprintf(stderr, "Unknown output format %s!\n", argv[i]);
+				exit(RETURN_ERROR);
+			}
+		}
+		else if (strcmp(argv[i], "--seed") == 0) {
+			seed = strtoul(argv[++i], NULL, 10);
+		}
+		else if (strcmp(argv[i], "--mutation-rate") == 0) {
+			mutationRate = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--crossover-rate") == 0) {
+			crossoverRate = atof(argv[++i]);
+		}
+		else {
+			fprintf(stderr, "Unknown option %s!\n", argv[i]);
+			exit(RETURN_ERROR);
+		}
+	}
+
+	if (pszWatchDirectory != NULL) {
+		exit(WatchPatchLibrary(pszWatchDirectory));
+	}
+	if (pszClassifyFileName != NULL) {
+		exit(ClassifyFile(pszClassifyFileName));
+	}
+	if (pszStatsPath != NULL) {
+		exit(ComputeStats(pszStatsPath, threadCount, pszStatsCsvBaseName));
+	}
+	if (pszCaptureSources != NULL) {
+		exit(CaptureDevices(pszCaptureSources, pszCaptureDirectory, captureTimeout));
+	}
+	if (pszFileName == NULL) {
 		fprintf(stderr, "Please specify a file name!\n");
 		exit(RETURN_ERROR);
 	}
+	if (generateCount > 0) {
+		if (pszOutputFileName == NULL) {
+			fprintf(stderr, "Please specify an output file name!\n");
+			exit(RETURN_ERROR);
+		}
+		exit(GeneratePatchFile(pszFileName, pszOutputFileName, outputFormat, generateCount, seed, mutationRate, crossoverRate));
+	}
+	if (pszFields != NULL) {
+		FieldPlan plan;
+		char szUnknown[64];
+		if (!CompileFieldPlan(pszFields, &plan, szUnknown, sizeof(szUnknown))) {
+			fprintf(stderr, "Unknown field %s!\n", szUnknown);
+			exit(RETURN_ERROR);
+		}
+		exit(DumpFileFields(pszFileName, &plan));
+	}
+	if (pszCacheDirectory != NULL) {
+		exit(DumpFileCached(pszCacheDirectory, cacheMaxSize, pszFileName));
+	}
+
 	FILE* pFile = NULL;
 	// open binary to avoid ascii code interpretation
-	errno_t err = fopen_s(&pFile, argv[1], "rb");
+	errno_t err = fopen_s(&pFile, pszFileName, "rb");
 	if (pFile == NULL) {
 		fprintf(stderr, "Incorrect file name!\n");
 		exit(RETURN_ERROR);
 	}
 
 	bool bAtLeastOneSinglePatchDataFound = false;
+	OutputSink sink;
+	InitFileSink(&sink, stdout);
 
 	// identify single patch data from sysex file
 	while (LocateSinglePatchData(pFile) == true) {
@@ -348,7 +822,7 @@ int _tmain(int argc, _TCHAR* argv[])
 		// read data into the path
 		ReadSinglePatchData(pFile, &patch);
 		// dump the patch data
-		DumpPatch(&patch);
+		DumpPatch(&patch, &sink);
 	}
 
 	//close the file
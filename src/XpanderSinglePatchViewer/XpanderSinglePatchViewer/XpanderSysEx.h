@@ -55,6 +55,9 @@ static const int PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH = 6;
 static const int PATCHNAME_LENGTH = 8;
 static const int OBWORDS_DATA_LENGTH = 196 - PATCHNAME_LENGTH;
 // 6 (intro) +196*2 (data+name) +1 (EOX) = 399
+// raw data length following the intro: 196 double bytes
+static const int SINGLE_PATCH_DATA_LENGTH = (OBWORDS_DATA_LENGTH + PATCHNAME_LENGTH) * 2;
+static const int SINGLE_PATCH_SYSEX_LENGTH = PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH + SINGLE_PATCH_DATA_LENGTH + 1;
 
 // 27 modulation sources
 static const int  MODULATION_SOURCE_COUNT = 27;
@@ -71,6 +74,61 @@ static const int MODULATION_SIGN_MASK = 0x40;
 //8th bit is quantize
 static const int MODULATION_QTZ_MASK = 0x80;
 
+//============================================================================
+// SYSTEM EXCLUSIVE COMMANDS
+//============================================================================
+
+// F0 10 <device number> <command byte 1> ... F7
+static const unsigned char SYSEX_STATUS = 0xF0;
+static const unsigned char SYSEX_EOX = 0xF7;
+static const unsigned char OBERHEIM_ID = 0x10;
+// Xpander and Matrix-12
+static const unsigned char XPANDER_DEVICE_NUMBER = 0x02;
+// Matrix-12 multi patch data dumps only
+static const unsigned char MATRIX12_MULTI_DEVICE_NUMBER = 0x04;
+static const int SYSEX_COMMAND_INTRO_LENGTH = 4;
+// command bytes are 7 bits values
+static const int SYSEX_COMMAND_MAX_COUNT = 128;
+
+// SysExCommands (command byte 1)
+typedef enum _SysExCommands {
+	SYSEXCMD_PRG_DUMP_REQUEST = 0x00,
+	SYSEXCMD_PRG_DUMP_FOLLOWS = 0x01,
+	SYSEXCMD_ALL_DUMP_REQUEST = 0x02,
+	SYSEXCMD_COPY = 0x04,
+	SYSEXCMD_DISPLAY_XPANDER = 0x05,
+	SYSEXCMD_DISPLAY_MATRIX12 = 0x06,
+	SYSEXCMD_STORE = 0x07,
+	SYSEXCMD_PAGE_EDIT = 0x0A,
+	SYSEXCMD_PAGE_SELECT = 0x0B,
+	SYSEXCMD_TRANSPOSE = 0x0C,
+	SYSEXCMD_PROGRAMMER_SWITCHES = 0x0D,
+	SYSEXCMD_UP_DOWN = 0x0E,
+	SYSEXCMD_MODULATION_EDIT = 0x0F,
+	SYSEXCMD_CARD_SELECT = 0x10
+} SysExCommands;
+static const NumberStringPair SysExCommandsNames[] = {
+		{ SYSEXCMD_PRG_DUMP_REQUEST, "PRG_DUMP_REQUEST" },
+		{ SYSEXCMD_PRG_DUMP_FOLLOWS, "PRG_DUMP_FOLLOWS" },
+		{ SYSEXCMD_ALL_DUMP_REQUEST, "ALL_DUMP_REQUEST" },
+		{ SYSEXCMD_COPY, "COPY" },
+		{ SYSEXCMD_DISPLAY_XPANDER, "DISPLAY_XPANDER" },
+		{ SYSEXCMD_DISPLAY_MATRIX12, "DISPLAY_MATRIX12" },
+		{ SYSEXCMD_STORE, "STORE" },
+		{ SYSEXCMD_PAGE_EDIT, "PAGE_EDIT" },
+		{ SYSEXCMD_PAGE_SELECT, "PAGE_SELECT" },
+		{ SYSEXCMD_TRANSPOSE, "TRANSPOSE" },
+		{ SYSEXCMD_PROGRAMMER_SWITCHES, "PROGRAMMER_SWITCHES" },
+		{ SYSEXCMD_UP_DOWN, "UP_DOWN" },
+		{ SYSEXCMD_MODULATION_EDIT, "MODULATION_EDIT" },
+		{ SYSEXCMD_CARD_SELECT, "CARD_SELECT" }
+};
+static const int SYSEXCOMMANDS_COUNT = 14;
+
+// program types of the program data dump messages (command byte 2)
+static const unsigned char PROGRAM_TYPE_VOICE = 0x00;
+static const unsigned char PROGRAM_TYPE_MULTI = 0x01;
+
 //============================================================================
 // SINGLE PATCH DATA TYPES
 //============================================================================
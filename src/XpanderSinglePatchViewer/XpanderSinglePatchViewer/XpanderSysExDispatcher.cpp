@@ -0,0 +1,181 @@
+//This file is part of XpanderSinglePatchViewer
+
+//XpanderSinglePatchViewer is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//XpanderSinglePatchViewer is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with XpanderSinglePatchViewer.
+//If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+//stdlib
+#include <string.h>
+
+#include "XpanderSysExDispatcher.h"
+
+//----------------------------------------------------------------------------
+void InitSysExDispatcher(SysExDispatcher* pDispatcher) {
+	memset(pDispatcher, 0, sizeof(SysExDispatcher));
+
+	// F0 10 <device> <command> <data...> F7
+	pDispatcher->lengths[SYSEXCMD_PRG_DUMP_REQUEST] = SYSEX_COMMAND_INTRO_LENGTH + 2 + 1;
+	pDispatcher->lengths[SYSEXCMD_ALL_DUMP_REQUEST] = SYSEX_COMMAND_INTRO_LENGTH + 1 + 1;
+	pDispatcher->lengths[SYSEXCMD_COPY] = SYSEX_COMMAND_INTRO_LENGTH + 2 + 1;
+	pDispatcher->lengths[SYSEXCMD_STORE] = SYSEX_COMMAND_INTRO_LENGTH + 1 + 1;
+	pDispatcher->lengths[SYSEXCMD_PAGE_SELECT] = SYSEX_COMMAND_INTRO_LENGTH + 2 + 1;
+	pDispatcher->lengths[SYSEXCMD_PROGRAMMER_SWITCHES] = SYSEX_COMMAND_INTRO_LENGTH + 2 + 1;
+	pDispatcher->lengths[SYSEXCMD_UP_DOWN] = SYSEX_COMMAND_INTRO_LENGTH + 1 + 1;
+	// program data dumps: only the voice data length is known, see GetExpectedLength()
+}
+
+//----------------------------------------------------------------------------
+void SetSysExHandler(SysExDispatcher* pDispatcher, unsigned char command, SysExHandler pHandler, void* pUser) {
+	command &= SYSEX_COMMAND_MAX_COUNT - 1;
+	pDispatcher->handlers[command] = pHandler;
+	pDispatcher->pUsers[command] = pUser;
+}
+
+//----------------------------------------------------------------------------
+void SetDefaultSysExHandler(SysExDispatcher* pDispatcher, SysExHandler pHandler, void* pUser) {
+	pDispatcher->defaultHandler = pHandler;
+	pDispatcher->pDefaultUser = pUser;
+}
+
+//----------------------------------------------------------------------------
+const char* GetSysExCommandName(unsigned char command) {
+	for (int i = 0; i < SYSEXCOMMANDS_COUNT; i++) {
+		if (SysExCommandsNames[i].iNumber == command) {
+			return SysExCommandsNames[i].pszString;
+		}
+	}
+	return "UNKNOWN";
+}
+
+//----------------------------------------------------------------------------
+/*! Expected length of an Oberheim message
+@return the message length, 0 if it is only known from the EOX
+*/
+static size_t GetExpectedLength(const SysExDispatcher* pDispatcher, const unsigned char* pMessage, size_t available) {
+	unsigned char command = pMessage[3];
+	if (command == SYSEXCMD_PRG_DUMP_FOLLOWS) {
+		// program type is needed
+		if (available > SYSEX_COMMAND_INTRO_LENGTH && pMessage[4] == PROGRAM_TYPE_VOICE) {
+			return SINGLE_PATCH_SYSEX_LENGTH;
+		}
+		return 0;
+	}
+	return pDispatcher->lengths[command];
+}
+
+//----------------------------------------------------------------------------
+/*! Find the end of a message: the first status byte after the F0
+@return offset of the status byte, or size if none
+*/
+static size_t FindStatusByte(const unsigned char* pData, size_t size, size_t from) {
+	for (size_t i = from; i < size; i++) {
+		if (pData[i] & 0x80) {
+			return i;
+		}
+	}
+	return size;
+}
+
+//----------------------------------------------------------------------------
+size_t DispatchSysEx(SysExDispatcher* pDispatcher, const unsigned char* pData, size_t size, unsigned long long streamOffset) {
+	size_t offset = 0;
+
+	while (offset < size) {
+		const unsigned char* pStart = (const unsigned char*)memchr(pData + offset, SYSEX_STATUS, size - offset);
+		if (pStart == NULL) {
+			return size;
+		}
+		offset = pStart - pData;
+		size_t available = size - offset;
+
+		SysExMessage message;
+		message.offset = streamOffset + offset;
+		message.pMessage = pStart;
+		message.bOberheim = false;
+		message.device = 0;
+		message.command = 0;
+
+		// the intro must be complete to know the message kind
+		size_t introLimit = (available < (size_t)SYSEX_COMMAND_INTRO_LENGTH) ? size : offset + SYSEX_COMMAND_INTRO_LENGTH;
+		size_t introEnd = FindStatusByte(pData, introLimit, offset + 1);
+		if (introEnd == size) {
+			pDispatcher->pendingScanned = 0;
+			return offset;
+		}
+		// the beginning of a message left by the previous call was already searched
+		size_t scanFrom = introEnd;
+		if (offset == 0 && pDispatcher->pendingScanned > introEnd) {
+			scanFrom = pDispatcher->pendingScanned;
+		}
+		pDispatcher->pendingScanned = 0;
+		size_t end = 0;
+		if (introEnd == offset + SYSEX_COMMAND_INTRO_LENGTH && pStart[1] == OBERHEIM_ID
+			&& (pStart[2] == XPANDER_DEVICE_NUMBER || pStart[2] == MATRIX12_MULTI_DEVICE_NUMBER)) {
+			message.bOberheim = true;
+			message.device = pStart[2];
+			message.command = pStart[3];
+
+			// fixed length: the EOX is known, only check that no status byte
+			// before it cut the message, else the first one is its end
+			size_t length = GetExpectedLength(pDispatcher, pStart, available);
+			if (length > 0 && length <= available && pStart[length - 1] == SYSEX_EOX) {
+				end = FindStatusByte(pData, offset + length - 1, scanFrom);
+			}
+		}
+		if (end == 0) {
+			end = FindStatusByte(pData, size, scanFrom);
+			if (end == size) {
+				pDispatcher->pendingScanned = size - offset;
+				return offset;
+			}
+		}
+
+		if (pData[end] != SYSEX_EOX) {
+			// interrupted: the status byte starts the next message
+			pDispatcher->truncatedCount++;
+			offset = end;
+			continue;
+		}
+		message.length = end + 1 - offset;
+
+		if (message.bOberheim) {
+			pDispatcher->commandCounts[message.command]++;
+			SysExHandler pHandler = pDispatcher->handlers[message.command];
+			if (pHandler != NULL) {
+				pHandler(pDispatcher->pUsers[message.command], &message);
+			}
+			else if (pDispatcher->defaultHandler != NULL) {
+				pDispatcher->defaultHandler(pDispatcher->pDefaultUser, &message);
+			}
+		}
+		else {
+			pDispatcher->otherCount++;
+			if (pDispatcher->defaultHandler != NULL) {
+				pDispatcher->defaultHandler(pDispatcher->pDefaultUser, &message);
+			}
+		}
+		offset = end + 1;
+	}
+	return size;
+}
+
+//----------------------------------------------------------------------------
+void EndSysExStream(SysExDispatcher* pDispatcher, size_t unconsumed) {
+	// DispatchSysEx() only leaves a message not yet terminated
+	if (unconsumed > 0) {
+		pDispatcher->truncatedCount++;
+	}
+	pDispatcher->pendingScanned = 0;
+}
@@ -0,0 +1,120 @@
+//This file is part of XpanderSinglePatchViewer
+
+//XpanderSinglePatchViewer is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//XpanderSinglePatchViewer is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with XpanderSinglePatchViewer.
+//If not, see <http://www.gnu.org/licenses/>.
+
+//============================================================================
+// System exclusive dispatcher: a stream of MIDI bytes is scanned once, each
+// F0 10 <device> <command> ... F7 message is routed through a table indexed
+// by the command byte to the handler registered for this command. Fixed
+// length commands are skipped by length, other messages by looking for the
+// EOX; the end of a message split between two buffers is searched from where
+// the previous call stopped.
+//============================================================================
+
+#ifndef _XPANDERSYSEXDISPATCHER__
+#define _XPANDERSYSEXDISPATCHER__
+
+#include <stddef.h>
+
+#include "XpanderSysEx.h"
+
+// a complete system exclusive message
+typedef struct _SysExMessage {
+	unsigned long long offset;		// stream offset of the F0 byte
+	const unsigned char* pMessage;	// the message, F0 and F7 included
+	size_t length;					// length of the message in bytes
+	bool bOberheim;					// true if F0 10 <02|04> <command>: Xpander or Matrix-12
+	unsigned char device;			// device number, Oberheim messages only
+	unsigned char command;			// command byte 1, Oberheim messages only
+} SysExMessage;
+
+/*! Called for each dispatched message
+@param [in] pUser: the user data registered with the handler
+@param [in] pMessage: the message, valid during the call only
+*/
+typedef void (*SysExHandler)(void* pUser, const SysExMessage* pMessage);
+
+typedef struct _SysExDispatcher {
+	// jump table, indexed by the command byte
+	SysExHandler handlers[SYSEX_COMMAND_MAX_COUNT];
+	void* pUsers[SYSEX_COMMAND_MAX_COUNT];
+	// message length of the fixed length commands, 0 for variable length
+	unsigned short lengths[SYSEX_COMMAND_MAX_COUNT];
+
+	// other system exclusive messages and Oberheim commands without handler
+	SysExHandler defaultHandler;
+	void* pDefaultUser;
+
+	// statistics
+	unsigned long long commandCounts[SYSEX_COMMAND_MAX_COUNT];	// Oberheim messages per command
+	unsigned long long otherCount;		// non-Oberheim system exclusive messages
+	unsigned long long truncatedCount;	// messages interrupted by another status byte or by the end of the stream
+
+	// bytes of the message left at the end of the previous buffer already
+	// searched for its end
+	size_t pendingScanned;
+} SysExDispatcher;
+
+//----------------------------------------------------------------------------
+/*! Initialize a dispatcher without any handler
+@param [out] pDispatcher: the dispatcher to initialize
+*/
+void InitSysExDispatcher(SysExDispatcher* pDispatcher);
+
+//----------------------------------------------------------------------------
+/*! Register the handler of a command
+@param [in] pDispatcher: the dispatcher
+@param [in] command: command byte 1 (SysExCommands)
+@param [in] pHandler: the handler, NULL to route the command to the default handler
+@param [in] pUser: passed to the handler
+*/
+void SetSysExHandler(SysExDispatcher* pDispatcher, unsigned char command, SysExHandler pHandler, void* pUser);
+
+//----------------------------------------------------------------------------
+/*! Register the handler of the messages without command handler
+@param [in] pDispatcher: the dispatcher
+@param [in] pHandler: the handler, NULL to ignore these messages
+@param [in] pUser: passed to the handler
+*/
+void SetDefaultSysExHandler(SysExDispatcher* pDispatcher, SysExHandler pHandler, void* pUser);
+
+//----------------------------------------------------------------------------
+/*! Dispatch all the complete messages of a buffer
+@param [in] pDispatcher: the dispatcher
+@param [in] pData: the MIDI bytes
+@param [in] size: size of the buffer in bytes
+@param [in] streamOffset: stream offset of the first byte of the buffer
+@return number of bytes consumed: size, or offset of a message not yet
+terminated at the end of the buffer. When streaming, these remaining bytes
+must be given again at the beginning of the next buffer, followed by the
+next ones.
+*/
+size_t DispatchSysEx(SysExDispatcher* pDispatcher, const unsigned char* pData, size_t size, unsigned long long streamOffset);
+
+//----------------------------------------------------------------------------
+/*! End of the stream: a message not yet terminated is counted as truncated
+@param [in] pDispatcher: the dispatcher
+@param [in] unconsumed: number of bytes not consumed by the last DispatchSysEx() call
+*/
+void EndSysExStream(SysExDispatcher* pDispatcher, size_t unconsumed);
+
+//----------------------------------------------------------------------------
+/*! Get the name of a command
+@param [in] command: command byte 1
+@return the name, "UNKNOWN" for undocumented commands
+*/
+const char* GetSysExCommandName(unsigned char command);
+
+#endif // _XPANDERSYSEXDISPATCHER__
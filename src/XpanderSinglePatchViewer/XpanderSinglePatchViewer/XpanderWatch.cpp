@@ -0,0 +1,325 @@
+//This file is part of XpanderSinglePatchViewer
+
+//XpanderSinglePatchViewer is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//XpanderSinglePatchViewer is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with XpanderSinglePatchViewer.
+//If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+//stdlib
+#include <stdlib.h>
+#include <string.h>
+
+#include "XpanderWatch.h"
+#include "XpanderHash.h"
+
+// files are read by chunks of this size
+static const size_t WATCH_READ_BUFFER_SIZE = 64 * 1024;
+// number of bytes before the previous end of a file checked to detect appends
+static const unsigned long long WATCH_TAIL_LENGTH = 4096;
+
+//----------------------------------------------------------------------------
+bool InitPatchLibraryWatch(PatchLibraryWatch* pWatch, const char* pszDirectory,
+	PatchUpdateCallback pCallback, void* pUser) {
+	memset(pWatch, 0, sizeof(PatchLibraryWatch));
+	if (strlen(pszDirectory) >= MAX_PATH) {
+		return false;
+	}
+	strcpy_s(pWatch->szDirectory, MAX_PATH, pszDirectory);
+	pWatch->pCallback = pCallback;
+	pWatch->pUser = pUser;
+	pWatch->pReadBuffer = (unsigned char*)malloc(WATCH_READ_BUFFER_SIZE);
+	return (pWatch->pReadBuffer != NULL);
+}
+
+//----------------------------------------------------------------------------
+void ReleasePatchLibraryWatch(PatchLibraryWatch* pWatch) {
+	for (int i = 0; i < pWatch->fileCount; i++) {
+		free(pWatch->pFiles[i].patches.pPatches);
+	}
+	free(pWatch->pFiles);
+	free(pWatch->pReadBuffer);
+	memset(pWatch, 0, sizeof(PatchLibraryWatch));
+}
+
+//----------------------------------------------------------------------------
+/*! Report an update of a cached patch
+*/
+static void ReportUpdate(PatchLibraryWatch* pWatch, PatchUpdateKinds kind, const WatchedFile* pFile, const CachedPatch* pPatch) {
+	PatchUpdate update;
+	update.kind = kind;
+	update.pszFileName = pFile->szName;
+	update.offset = pPatch->offset;
+	update.programNumber = pPatch->programNumber;
+	update.pPatch = &pPatch->patch;
+	pWatch->pCallback(pWatch->pUser, &update);
+}
+
+//----------------------------------------------------------------------------
+/*! Scanner callback: append the patch to a CachedPatchList
+*/
+static void AppendCachedPatch(void* pUser, unsigned long long offset, const unsigned char* pIntro, const SinglePatch* pPatch) {
+	CachedPatchList* pList = (CachedPatchList*)pUser;
+	if (pList->count == pList->capacity) {
+		int capacity = (pList->capacity == 0) ? 128 : pList->capacity * 2;
+		CachedPatch* pPatches = (CachedPatch*)realloc(pList->pPatches, capacity * sizeof(CachedPatch));
+		if (pPatches == NULL) {
+			// out of memory: the patch is ignored
+			return;
+		}
+		pList->pPatches = pPatches;
+		pList->capacity = capacity;
+	}
+	CachedPatch* pCached = &pList->pPatches[pList->count++];
+	pCached->offset = offset;
+	pCached->programNumber = pIntro[5];
+	pCached->patch = *pPatch;
+}
+
+//----------------------------------------------------------------------------
+/*! Read a file from an offset to its end, hashing the bytes and feeding
+them to a scanner.
+@return number of bytes read, or -1 if the file can not be opened
+*/
+static long long ReadFileFrom(PatchLibraryWatch* pWatch, const char* pszPath, unsigned long long from,
+	unsigned long long* pHash, SinglePatchScanner* pScanner, CachedPatchList* pList) {
+	FILE* pFile = NULL;
+	fopen_s(&pFile, pszPath, "rb");
+	if (pFile == NULL) {
+		return -1;
+	}
+	if (_fseeki64(pFile, (long long)from, SEEK_SET) != 0) {
+		fclose(pFile);
+		return -1;
+	}
+
+	long long totalRead = 0;
+	size_t nbBytesRead = 0;
+	while ((nbBytesRead = fread(pWatch->pReadBuffer, sizeof(char), WATCH_READ_BUFFER_SIZE, pFile)) > 0) {
+		if (pHash != NULL) {
+			*pHash = HashBytes(*pHash, pWatch->pReadBuffer, nbBytesRead);
+		}
+		if (pScanner != NULL) {
+			FeedSinglePatchScanner(pScanner, pWatch->pReadBuffer, nbBytesRead, AppendCachedPatch, pList);
+		}
+		totalRead += nbBytesRead;
+	}
+	fclose(pFile);
+	return totalRead;
+}
+
+//----------------------------------------------------------------------------
+/*! Hash the WATCH_TAIL_LENGTH bytes before an offset of a file
+@return false if the file can not be read
+*/
+static bool HashFileTail(const char* pszPath, unsigned long long end, unsigned long long* pTailHash) {
+	unsigned char tail[WATCH_TAIL_LENGTH];
+	unsigned long long start = (end > WATCH_TAIL_LENGTH) ? end - WATCH_TAIL_LENGTH : 0;
+	size_t length = (size_t)(end - start);
+
+	FILE* pFile = NULL;
+	fopen_s(&pFile, pszPath, "rb");
+	if (pFile == NULL) {
+		return false;
+	}
+	bool bRead = (_fseeki64(pFile, (long long)start, SEEK_SET) == 0)
+		&& (fread(tail, sizeof(char), length, pFile) == length);
+	fclose(pFile);
+
+	*pTailHash = HashBytes(HASH_SEED, tail, length);
+	return bRead;
+}
+
+//----------------------------------------------------------------------------
+/*! Compare the previous and the new patches of a file and report the
+differences. Both lists are sorted by offset.
+*/
+static void ReportDifferences(PatchLibraryWatch* pWatch, const WatchedFile* pFile,
+	const CachedPatchList* pOld, const CachedPatchList* pNew) {
+	int iOld = 0;
+	int iNew = 0;
+	while (iOld < pOld->count || iNew < pNew->count) {
+		const CachedPatch* pOldPatch = (iOld < pOld->count) ? &pOld->pPatches[iOld] : NULL;
+		const CachedPatch* pNewPatch = (iNew < pNew->count) ? &pNew->pPatches[iNew] : NULL;
+
+		if (pNewPatch == NULL || (pOldPatch != NULL && pOldPatch->offset < pNewPatch->offset)) {
+			ReportUpdate(pWatch, PATCH_REMOVED, pFile, pOldPatch);
+			iOld++;
+		}
+		else if (pOldPatch == NULL || pNewPatch->offset < pOldPatch->offset) {
+			ReportUpdate(pWatch, PATCH_ADDED, pFile, pNewPatch);
+			iNew++;
+		}
+		else {
+			// same offset
+			if (pOldPatch->programNumber != pNewPatch->programNumber
+				|| memcmp(&pOldPatch->patch, &pNewPatch->patch, sizeof(SinglePatch)) != 0) {
+				ReportUpdate(pWatch, PATCH_CHANGED, pFile, pNewPatch);
+			}
+			iOld++;
+			iNew++;
+		}
+	}
+}
+
+//----------------------------------------------------------------------------
+/*! Bring the cache entry of a file up to date
+@param [in] size: file size from the directory scan
+@param [in] writeTime: last write time from the directory scan
+*/
+static void UpdateWatchedFile(PatchLibraryWatch* pWatch, WatchedFile* pFile,
+	unsigned long long size, unsigned long long writeTime) {
+	if (size == pFile->size && writeTime == pFile->writeTime) {
+		// unchanged
+		return;
+	}
+
+	char szPath[MAX_PATH];
+	sprintf_s(szPath, MAX_PATH, "%s\\%s", pWatch->szDirectory, pFile->szName);
+
+	// append-only: the file grew and the bytes before its previous end are
+	// unchanged. Only the appended bytes are read: the content hash goes on
+	// from its saved state, and the saved scanner from the previous end.
+	unsigned long long tailHash = 0;
+	if (pFile->size > 0 && size > pFile->size
+		&& HashFileTail(szPath, pFile->size, &tailHash) && tailHash == pFile->tailHash) {
+		int previousCount = pFile->patches.count;
+		long long appended = ReadFileFrom(pWatch, szPath, pFile->size, &pFile->hash, &pFile->scanner, &pFile->patches);
+		if (appended < 0) {
+			return;
+		}
+		pFile->size += appended;
+		pFile->writeTime = writeTime;
+		HashFileTail(szPath, pFile->size, &pFile->tailHash);
+		for (int i = previousCount; i < pFile->patches.count; i++) {
+			ReportUpdate(pWatch, PATCH_ADDED, pFile, &pFile->patches.pPatches[i]);
+		}
+		return;
+	}
+
+	// re-scan the whole file
+	unsigned long long hash = HASH_SEED;
+	SinglePatchScanner scanner;
+	InitSinglePatchScanner(&scanner);
+	CachedPatchList patches;
+	memset(&patches, 0, sizeof(CachedPatchList));
+
+	long long fileSize = ReadFileFrom(pWatch, szPath, 0, &hash, &scanner, &patches);
+	if (fileSize < 0) {
+		free(patches.pPatches);
+		return;
+	}
+
+	if ((unsigned long long)fileSize != pFile->size || hash != pFile->hash) {
+		ReportDifferences(pWatch, pFile, &pFile->patches, &patches);
+	}
+	free(pFile->patches.pPatches);
+	pFile->patches = patches;
+	pFile->scanner = scanner;
+	pFile->size = fileSize;
+	pFile->writeTime = writeTime;
+	pFile->hash = hash;
+	HashFileTail(szPath, pFile->size, &pFile->tailHash);
+}
+
+//----------------------------------------------------------------------------
+/*! Find or create the cache entry of a file
+@return NULL on memory allocation error
+*/
+static WatchedFile* GetWatchedFile(PatchLibraryWatch* pWatch, const char* pszName) {
+	for (int i = 0; i < pWatch->fileCount; i++) {
+		if (_stricmp(pWatch->pFiles[i].szName, pszName) == 0) {
+			return &pWatch->pFiles[i];
+		}
+	}
+
+	if (pWatch->fileCount == pWatch->fileCapacity) {
+		int capacity = (pWatch->fileCapacity == 0) ? 64 : pWatch->fileCapacity * 2;
+		WatchedFile* pFiles = (WatchedFile*)realloc(pWatch->pFiles, capacity * sizeof(WatchedFile));
+		if (pFiles == NULL) {
+			return NULL;
+		}
+		pWatch->pFiles = pFiles;
+		pWatch->fileCapacity = capacity;
+	}
+	WatchedFile* pFile = &pWatch->pFiles[pWatch->fileCount++];
+	memset(pFile, 0, sizeof(WatchedFile));
+	strcpy_s(pFile->szName, MAX_PATH, pszName);
+	pFile->hash = HASH_SEED;
+	InitSinglePatchScanner(&pFile->scanner);
+	return pFile;
+}
+
+//----------------------------------------------------------------------------
+bool RescanPatchLibrary(PatchLibraryWatch* pWatch) {
+	char szPattern[MAX_PATH];
+	sprintf_s(szPattern, MAX_PATH, "%s\\*", pWatch->szDirectory);
+
+	WIN32_FIND_DATA findData;
+	HANDLE hFind = FindFirstFile(szPattern, &findData);
+	if (hFind == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	for (int i = 0; i < pWatch->fileCount; i++) {
+		pWatch->pFiles[i].bSeen = false;
+	}
+
+	do {
+		if ((findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == FILE_ATTRIBUTE_DIRECTORY) {
+			continue;
+		}
+		WatchedFile* pFile = GetWatchedFile(pWatch, findData.cFileName);
+		if (pFile == NULL) {
+			continue;
+		}
+		pFile->bSeen = true;
+		unsigned long long size = ((unsigned long long)findData.nFileSizeHigh << 32) | findData.nFileSizeLow;
+		unsigned long long writeTime = ((unsigned long long)findData.ftLastWriteTime.dwHighDateTime << 32)
+			| findData.ftLastWriteTime.dwLowDateTime;
+		UpdateWatchedFile(pWatch, pFile, size, writeTime);
+	} while (FindNextFile(hFind, &findData));
+	FindClose(hFind);
+
+	// files removed from the directory
+	for (int i = pWatch->fileCount - 1; i >= 0; i--) {
+		WatchedFile* pFile = &pWatch->pFiles[i];
+		if (pFile->bSeen) {
+			continue;
+		}
+		for (int j = 0; j < pFile->patches.count; j++) {
+			ReportUpdate(pWatch, PATCH_REMOVED, pFile, &pFile->patches.pPatches[j]);
+		}
+		free(pFile->patches.pPatches);
+		*pFile = pWatch->pFiles[--pWatch->fileCount];
+	}
+	return true;
+}
+
+//----------------------------------------------------------------------------
+bool RunPatchLibraryWatch(PatchLibraryWatch* pWatch) {
+	HANDLE hChange = FindFirstChangeNotification(pWatch->szDirectory, FALSE,
+		FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE);
+	if (hChange == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	// first scan once the notification is set, so that no change is missed
+	bool bWatching = RescanPatchLibrary(pWatch);
+	while (bWatching && WaitForSingleObject(hChange, INFINITE) == WAIT_OBJECT_0) {
+		bWatching = RescanPatchLibrary(pWatch) && (FindNextChangeNotification(hChange) != FALSE);
+	}
+
+	FindCloseChangeNotification(hChange);
+	return false;
+}
@@ -0,0 +1,127 @@
+//This file is part of XpanderSinglePatchViewer
+
+//XpanderSinglePatchViewer is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//XpanderSinglePatchViewer is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with XpanderSinglePatchViewer.
+//If not, see <http://www.gnu.org/licenses/>.
+
+//============================================================================
+// Watch mode: keeps the decoded single patches of every file of a patch
+// library directory, and re-scans only the files that changed.
+// Each file is identified by its size, last write time and content hash.
+// When a file only grew and the last bytes before its previous end are
+// unchanged (append-only capture files), only the appended bytes are read:
+// the content hash and the single patch scanner resume from their saved
+// state at the previous end.
+// Consumers get a feed of added, removed and changed patches.
+//============================================================================
+
+#ifndef _XPANDERWATCH__
+#define _XPANDERWATCH__
+
+#include <windows.h>
+
+#include "XpanderSysEx.h"
+#include "XpanderSinglePatch.h"
+
+// PatchUpdate kinds
+typedef enum _PatchUpdateKinds {
+	PATCH_ADDED,
+	PATCH_REMOVED,
+	PATCH_CHANGED
+} PatchUpdateKinds;
+static const char* PatchUpdateKindsNames[] = {
+	"ADDED", "REMOVED", "CHANGED"
+};
+
+typedef struct _PatchUpdate {
+	PatchUpdateKinds kind;
+	const char* pszFileName;		// file name in the watched directory
+	unsigned long long offset;		// offset of the message in the file
+	unsigned char programNumber;	// program number from the intro
+	const SinglePatch* pPatch;		// the new patch, or the removed one
+} PatchUpdate;
+
+/*! Called for each update of the patch library
+@param [in] pUser: the watch user data
+@param [in] pUpdate: the update, only valid during the call
+*/
+typedef void (*PatchUpdateCallback)(void* pUser, const PatchUpdate* pUpdate);
+
+// a decoded patch of a file
+typedef struct _CachedPatch {
+	unsigned long long offset;
+	unsigned char programNumber;
+	SinglePatch patch;
+} CachedPatch;
+
+typedef struct _CachedPatchList {
+	CachedPatch* pPatches;
+	int count;
+	int capacity;
+} CachedPatchList;
+
+// cache entry of a file of the directory
+typedef struct _WatchedFile {
+	char szName[MAX_PATH];
+	unsigned long long size;		// bytes scanned so far
+	unsigned long long writeTime;	// last write time when scanned
+	unsigned long long hash;		// content hash of the scanned bytes
+	unsigned long long tailHash;	// content hash of the last scanned bytes
+	SinglePatchScanner scanner;		// scanner state at the end of the scanned bytes
+	CachedPatchList patches;		// decoded patches, by increasing offset
+	bool bSeen;						// found by the current directory scan
+} WatchedFile;
+
+typedef struct _PatchLibraryWatch {
+	char szDirectory[MAX_PATH];
+	WatchedFile* pFiles;
+	int fileCount;
+	int fileCapacity;
+	unsigned char* pReadBuffer;
+	PatchUpdateCallback pCallback;
+	void* pUser;
+} PatchLibraryWatch;
+
+//----------------------------------------------------------------------------
+/*! Initialize a watch on a patch library directory, with an empty cache
+@param [out] pWatch: the watch to initialize
+@param [in] pszDirectory: the directory to watch
+@param [in] pCallback: called for each update
+@param [in] pUser: passed to the callback
+@return false on memory allocation error or if the directory name is too long
+*/
+bool InitPatchLibraryWatch(PatchLibraryWatch* pWatch, const char* pszDirectory,
+	PatchUpdateCallback pCallback, void* pUser);
+
+//----------------------------------------------------------------------------
+/*! Free the cache of a watch
+@param [in] pWatch: the watch to release
+*/
+void ReleasePatchLibraryWatch(PatchLibraryWatch* pWatch);
+
+//----------------------------------------------------------------------------
+/*! Compare the directory with the cache, scan the new or changed files and
+report the updates.
+@param [in] pWatch: the watch
+@return false if the directory can not be read
+*/
+bool RescanPatchLibrary(PatchLibraryWatch* pWatch);
+
+//----------------------------------------------------------------------------
+/*! Scan the directory, then wait for changes and re-scan, forever
+@param [in] pWatch: the watch
+@return false when the directory can not be watched any more
+*/
+bool RunPatchLibraryWatch(PatchLibraryWatch* pWatch);
+
+#endif // _XPANDERWATCH__
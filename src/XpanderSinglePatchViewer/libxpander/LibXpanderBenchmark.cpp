@@ -0,0 +1,132 @@
+//This file is part of XpanderSinglePatchViewer
+
+//XpanderSinglePatchViewer is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//XpanderSinglePatchViewer is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with XpanderSinglePatchViewer.
+//If not, see <http://www.gnu.org/licenses/>.
+
+//============================================================================
+// libxpander FFI call overhead benchmark: the same patches are decoded with
+// increasing batch sizes, showing how the per-call cost is amortized.
+// Usage: LibXpanderBenchmark [patch count]
+//============================================================================
+
+// windows stuff
+#include "stdafx.h"
+#include <windows.h>
+
+//stdlib
+#include <stdlib.h>
+#include <string.h>
+
+#include "libxpander.h"
+
+static const int DEFAULT_PATCH_COUNT = 100000;
+static const int BATCH_SIZES[] = { 1, 4, 16, 64, 256, 1024, 4096 };
+static const int BATCH_SIZES_COUNT = 7;
+static const int MAX_BATCH_SIZE = 4096;
+
+//----------------------------------------------------------------------------
+/*! Decode the whole buffer, maxPatches at a time
+@return number of decoded patches
+*/
+static int DecodeAll(const unsigned char* pData, size_t size, XpanderPackedPatch* pPatches, size_t* pOffsets,
+	unsigned int* pErrors, int maxPatches, int* pCallCount) {
+	int patchCount = 0;
+	size_t offset = 0;
+	*pCallCount = 0;
+	while (offset < size) {
+		int count = XpanderDecodeBatch(pData, size, &offset, pPatches, pOffsets, pErrors, maxPatches);
+		(*pCallCount)++;
+		if (count <= 0) {
+			break;
+		}
+		patchCount += count;
+	}
+	return patchCount;
+}
+
+//----------------------------------------------------------------------------
+int _tmain(int argc, _TCHAR* argv[])
+{
+	if (XpanderGetAbiVersion() != LIBXPANDER_ABI_VERSION) {
+		fprintf(stderr, "libxpander ABI version mismatch!\n");
+		return 1;
+	}
+	int patchCount = (argc > 1) ? atoi(argv[1]) : DEFAULT_PATCH_COUNT;
+	if (patchCount <= 0) {
+		fprintf(stderr, "Please specify a patch count!\n");
+		return 1;
+	}
+
+	// sysex buffer built with the library itself
+	XpanderPackedPatch* pPatches = (XpanderPackedPatch*)malloc(MAX_BATCH_SIZE * sizeof(XpanderPackedPatch));
+	size_t* pOffsets = (size_t*)malloc(MAX_BATCH_SIZE * sizeof(size_t));
+	unsigned int* pErrors = (unsigned int*)malloc(MAX_BATCH_SIZE * sizeof(unsigned int));
+	size_t size = (size_t)patchCount * XPANDER_SINGLE_PATCH_SYSEX_LENGTH;
+	unsigned char* pData = (unsigned char*)malloc(size);
+	if (pPatches == NULL || pOffsets == NULL || pErrors == NULL || pData == NULL) {
+		fprintf(stderr, "Not enough memory!\n");
+		return 1;
+	}
+	XpanderPackedPatch patch;
+	memset(&patch, 0, sizeof(XpanderPackedPatch));
+	strcpy_s(patch.name, sizeof(patch.name), "BENCH");
+	for (int i = 0; i < patchCount; i++) {
+		// 0 and 1 are valid values for every field
+		patch.data[i % XPANDER_PATCH_DATA_LENGTH] = (unsigned char)((i / XPANDER_PATCH_DATA_LENGTH) & 0x01);
+		patch.programNumber = (unsigned char)(i % 100);
+		XpanderEncodeBatch(&patch, 1, pData + (size_t)i * XPANDER_SINGLE_PATCH_SYSEX_LENGTH);
+	}
+
+	LARGE_INTEGER frequency, start, end;
+	QueryPerformanceFrequency(&frequency);
+
+	fprintf(stdout, "%d patches, %llu bytes\n", patchCount, (unsigned long long)size);
+	fprintf(stdout, "batch size\tcalls\ttime (ms)\tns/patch\tns/call\n");
+	for (int i = 0; i < BATCH_SIZES_COUNT; i++) {
+		int callCount = 0;
+		QueryPerformanceCounter(&start);
+		int decodedCount = DecodeAll(pData, size, pPatches, pOffsets, pErrors, BATCH_SIZES[i], &callCount);
+		QueryPerformanceCounter(&end);
+
+		double seconds = (double)(end.QuadPart - start.QuadPart) / frequency.QuadPart;
+		if (decodedCount != patchCount) {
+			fprintf(stderr, "Only %d patches decoded!\n", decodedCount);
+			return 1;
+		}
+		fprintf(stdout, "%d\t\t%d\t%.3f\t\t%.1f\t\t%.1f\n", BATCH_SIZES[i], callCount, seconds * 1000.0,
+			seconds * 1e9 / patchCount, seconds * 1e9 / callCount);
+	}
+
+	// formatting, one call per patch
+	char* pText = (char*)malloc(XPANDER_FORMAT_BUFFER_SIZE);
+	size_t offset = 0;
+	int count = XpanderDecodeBatch(pData, size, &offset, pPatches, pOffsets, pErrors, MAX_BATCH_SIZE);
+	QueryPerformanceCounter(&start);
+	int formattedCount = 0;
+	for (int i = 0; i < count; i++) {
+		if (XpanderFormatPatch(&pPatches[i], pText, XPANDER_FORMAT_BUFFER_SIZE, NULL) == XPANDER_OK) {
+			formattedCount++;
+		}
+	}
+	QueryPerformanceCounter(&end);
+	double seconds = (double)(end.QuadPart - start.QuadPart) / frequency.QuadPart;
+	fprintf(stdout, "format: %d patches in %.3f ms (%.1f us/patch)\n", formattedCount, seconds * 1000.0, seconds * 1e6 / count);
+
+	free(pText);
+	free(pData);
+	free(pErrors);
+	free(pOffsets);
+	free(pPatches);
+	return 0;
+}
@@ -0,0 +1,168 @@
+//This file is part of XpanderSinglePatchViewer
+
+//XpanderSinglePatchViewer is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//XpanderSinglePatchViewer is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with XpanderSinglePatchViewer.
+//If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+//stdlib
+#include <string.h>
+
+#include "libxpander.h"
+#include "XpanderSysEx.h"
+#include "XpanderSinglePatch.h"
+
+// the ABI structs must not depend on the compiler settings
+typedef char XpanderPackedPatchSizeCheck[(sizeof(XpanderPackedPatch) == 200) ? 1 : -1];
+typedef char XpanderPatchDataLengthCheck[(XPANDER_PATCH_DATA_LENGTH == OBWORDS_DATA_LENGTH) ? 1 : -1];
+typedef char XpanderSysExLengthCheck[(XPANDER_SINGLE_PATCH_SYSEX_LENGTH == SINGLE_PATCH_SYSEX_LENGTH) ? 1 : -1];
+
+static const unsigned char MAX_PROGRAM_NUMBER = 99;
+
+//----------------------------------------------------------------------------
+/*! Check the encoding of a single patch message
+@return XPANDER_PATCH_xxx mask
+*/
+static unsigned int CheckSinglePatchMessage(const unsigned char* pMessage) {
+	unsigned int errors = XPANDER_PATCH_OK;
+	if (pMessage[SINGLE_PATCH_SYSEX_LENGTH - 1] != SYSEX_EOX) {
+		errors |= XPANDER_PATCH_NO_EOX;
+	}
+	if (pMessage[5] > MAX_PROGRAM_NUMBER) {
+		errors |= XPANDER_PATCH_BAD_PROGRAM;
+	}
+	// low bytes: 7 bits, high bytes: 1 bit (values) or 0 (name)
+	const unsigned char* pData = pMessage + PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH;
+	unsigned char bad = 0;
+	for (int i = 0; i < OBWORDS_DATA_LENGTH; i++) {
+		bad |= (pData[0] & 0x80) | (pData[1] & 0xFE);
+		pData += 2;
+	}
+	for (int i = 0; i < PATCHNAME_LENGTH; i++) {
+		bad |= (pData[0] & 0x80) | pData[1];
+		pData += 2;
+	}
+	if (bad != 0) {
+		errors |= XPANDER_PATCH_BAD_ENCODING;
+	}
+	return errors;
+}
+
+//----------------------------------------------------------------------------
+/*! Convert a SinglePatch struct to the ABI struct
+*/
+static void PackSinglePatch(const SinglePatch* pPatch, unsigned char programNumber, XpanderPackedPatch* pPacked) {
+	memcpy(pPacked->data, pPatch, XPANDER_PATCH_DATA_LENGTH);
+	for (int i = 0; i < PATCHNAME_LENGTH; i++) {
+		pPacked->name[i] = (char)pPatch->name.character[i];
+	}
+	pPacked->name[PATCHNAME_LENGTH] = '\0';
+	pPacked->programNumber = programNumber;
+	pPacked->reserved[0] = 0;
+	pPacked->reserved[1] = 0;
+}
+
+//----------------------------------------------------------------------------
+/*! Convert the ABI struct to a SinglePatch struct
+*/
+static void UnpackSinglePatch(const XpanderPackedPatch* pPacked, SinglePatch* pPatch) {
+	memcpy(pPatch, pPacked->data, XPANDER_PATCH_DATA_LENGTH);
+	for (int i = 0; i < PATCHNAME_LENGTH; i++) {
+		pPatch->name.character[i] = (wchar_t)(unsigned char)pPacked->name[i];
+	}
+	pPatch->name.character[PATCHNAME_LENGTH] = L'\0';
+}
+
+//----------------------------------------------------------------------------
+LIBXPANDER_API int XPANDER_CALL XpanderGetAbiVersion(void) {
+	return LIBXPANDER_ABI_VERSION;
+}
+
+//----------------------------------------------------------------------------
+LIBXPANDER_API int XPANDER_CALL XpanderDecodeBatch(const unsigned char* pData, size_t size, size_t* pOffset,
+	XpanderPackedPatch* pPatches, size_t* pOffsets, unsigned int* pErrors, int maxPatches) {
+	if (pData == NULL || pOffset == NULL || pPatches == NULL || maxPatches < 0) {
+		return XPANDER_ERROR_INVALID_ARGUMENT;
+	}
+
+	int patchCount = 0;
+	size_t offset = FindSinglePatchData(pData, size, *pOffset);
+	while (offset < size && patchCount < maxPatches) {
+		const unsigned char* pMessage = pData + offset;
+		SinglePatch patch;
+		RepackSinglePatchData(pMessage + PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH, &patch);
+		PackSinglePatch(&patch, pMessage[5], &pPatches[patchCount]);
+
+		if (pOffsets != NULL) {
+			pOffsets[patchCount] = offset;
+		}
+		if (pErrors != NULL) {
+			unsigned int errors = CheckSinglePatchMessage(pMessage);
+			if (!IsSinglePatchDumpable(&patch)) {
+				errors |= XPANDER_PATCH_OUT_OF_RANGE;
+			}
+			pErrors[patchCount] = errors;
+		}
+
+		patchCount++;
+		offset = FindSinglePatchData(pData, size, offset + SINGLE_PATCH_SYSEX_LENGTH);
+	}
+	*pOffset = offset;
+	return patchCount;
+}
+
+//----------------------------------------------------------------------------
+LIBXPANDER_API int XPANDER_CALL XpanderEncodeBatch(const XpanderPackedPatch* pPatches, int count, unsigned char* pData) {
+	if (pPatches == NULL || pData == NULL || count < 0) {
+		return XPANDER_ERROR_INVALID_ARGUMENT;
+	}
+	for (int i = 0; i < count; i++) {
+		SinglePatch patch;
+		UnpackSinglePatch(&pPatches[i], &patch);
+		EncodeSinglePatchData(&patch, pPatches[i].programNumber, pData);
+		pData += SINGLE_PATCH_SYSEX_LENGTH;
+	}
+	return XPANDER_OK;
+}
+
+//----------------------------------------------------------------------------
+LIBXPANDER_API int XPANDER_CALL XpanderFormatPatch(const XpanderPackedPatch* pPatch, char* pBuffer, size_t bufferSize, size_t* pLength) {
+	if (pPatch == NULL || pBuffer == NULL || bufferSize == 0) {
+		return XPANDER_ERROR_INVALID_ARGUMENT;
+	}
+	if (pLength != NULL) {
+		*pLength = 0;
+	}
+	pBuffer[0] = '\0';
+
+	SinglePatch patch;
+	UnpackSinglePatch(pPatch, &patch);
+	if (!IsSinglePatchDumpable(&patch)) {
+		return XPANDER_ERROR_OUT_OF_RANGE;
+	}
+
+	unsigned char intro[PRG_DUMP_DATA_FOLLOWS_INTRO_LENGTH] = { SYSEX_STATUS, OBERHEIM_ID, XPANDER_DEVICE_NUMBER,
+		SYSEXCMD_PRG_DUMP_FOLLOWS, PROGRAM_TYPE_VOICE, pPatch->programNumber };
+	OutputSink sink;
+	InitBufferSink(&sink, pBuffer, bufferSize);
+	DumpPatchHeader(intro, &sink);
+	DumpPatch(&patch, &sink);
+	if (sink.bTruncated) {
+		return XPANDER_ERROR_BUFFER_TOO_SMALL;
+	}
+	if (pLength != NULL) {
+		*pLength = sink.bufferUsed;
+	}
+	return XPANDER_OK;
+}
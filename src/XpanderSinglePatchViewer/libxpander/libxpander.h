@@ -0,0 +1,121 @@
+//This file is part of XpanderSinglePatchViewer
+
+//XpanderSinglePatchViewer is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+
+//XpanderSinglePatchViewer is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+
+//You should have received a copy of the GNU General Public License
+//along with XpanderSinglePatchViewer.
+//If not, see <http://www.gnu.org/licenses/>.
+
+//============================================================================
+// libxpander: Xpander/Matrix 12 single patch decoding as a shared library.
+//
+// Stable C ABI:
+// - plain C types only, explicitly sized structs, __cdecl calling convention
+// - no global state: every function only works on the caller buffers, and
+//   can be called concurrently from any number of threads
+// - batch functions decode many patches per call to amortize the FFI call
+//   overhead (see LibXpanderBenchmark.cpp)
+// New functions may be added, existing ones are never changed: check
+// XpanderGetAbiVersion() against LIBXPANDER_ABI_VERSION.
+//============================================================================
+
+#ifndef _LIBXPANDER__
+#define _LIBXPANDER__
+
+#include <stddef.h>
+
+#ifdef LIBXPANDER_EXPORTS
+#define LIBXPANDER_API __declspec(dllexport)
+#else
+#define LIBXPANDER_API __declspec(dllimport)
+#endif
+#define XPANDER_CALL __cdecl
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LIBXPANDER_ABI_VERSION 1
+
+// return codes
+#define XPANDER_OK 0
+#define XPANDER_ERROR_INVALID_ARGUMENT -1	// NULL pointer or negative count
+#define XPANDER_ERROR_BUFFER_TOO_SMALL -2	// the output did not fit the caller buffer
+#define XPANDER_ERROR_OUT_OF_RANGE -3		// the patch can not be formatted
+
+// decoded patch error mask bits: the patch is decoded anyway
+#define XPANDER_PATCH_OK 0x00
+#define XPANDER_PATCH_NO_EOX 0x01			// no F7 at the end of the message
+#define XPANDER_PATCH_BAD_ENCODING 0x02		// a double byte is not 0xxx xxxx 0000 000x
+#define XPANDER_PATCH_BAD_PROGRAM 0x04		// program number is not 0 to 99
+#define XPANDER_PATCH_OUT_OF_RANGE 0x08		// an enum value is out of range, can not be formatted
+
+#define XPANDER_PATCH_DATA_LENGTH 188
+#define XPANDER_PATCH_NAME_LENGTH 8
+// a single patch message: F0 10 02 01 00 <program>, 196 double bytes, F7
+#define XPANDER_SINGLE_PATCH_SYSEX_LENGTH 399
+
+// a decoded single patch: 200 bytes, no padding
+typedef struct _XpanderPackedPatch {
+	unsigned char data[XPANDER_PATCH_DATA_LENGTH];	// 8 bits values, in SinglePatch order (XpanderSysEx.h)
+	char name[XPANDER_PATCH_NAME_LENGTH + 1];		// ASCII, zero terminated
+	unsigned char programNumber;					// from the message intro
+	unsigned char reserved[2];						// always 0
+} XpanderPackedPatch;
+
+// a caller buffer of this size always fits a formatted patch
+#define XPANDER_FORMAT_BUFFER_SIZE 8192
+
+//----------------------------------------------------------------------------
+/*! Get the ABI version of the library
+@return LIBXPANDER_ABI_VERSION of the library build
+*/
+LIBXPANDER_API int XPANDER_CALL XpanderGetAbiVersion(void);
+
+//----------------------------------------------------------------------------
+/*! Decode the single patch messages of a buffer
+@param [in] pData: the raw sysex buffer
+@param [in] size: size of the buffer in bytes
+@param [in,out] pOffset: offset to start decoding at; on return, offset to
+continue from in the next call (size when the whole buffer was decoded)
+@param [out] pPatches: maxPatches decoded patches
+@param [out] pOffsets: maxPatches offsets of the F0 bytes, may be NULL
+@param [out] pErrors: maxPatches XPANDER_PATCH_xxx masks, may be NULL
+@param [in] maxPatches: size of the caller arrays
+@return number of decoded patches, or XPANDER_ERROR_INVALID_ARGUMENT
+*/
+LIBXPANDER_API int XPANDER_CALL XpanderDecodeBatch(const unsigned char* pData, size_t size, size_t* pOffset,
+	XpanderPackedPatch* pPatches, size_t* pOffsets, unsigned int* pErrors, int maxPatches);
+
+//----------------------------------------------------------------------------
+/*! Encode patches to single patch messages, reverse of XpanderDecodeBatch()
+@param [in] pPatches: the patches to encode
+@param [in] count: number of patches
+@param [out] pData: count * XPANDER_SINGLE_PATCH_SYSEX_LENGTH bytes
+@return XPANDER_OK or XPANDER_ERROR_INVALID_ARGUMENT
+*/
+LIBXPANDER_API int XPANDER_CALL XpanderEncodeBatch(const XpanderPackedPatch* pPatches, int count, unsigned char* pData);
+
+//----------------------------------------------------------------------------
+/*! Format a patch with human-readable informations, as XpanderSinglePatchViewer
+@param [in] pPatch: the patch to format
+@param [out] pBuffer: the caller buffer, always zero terminated
+@param [in] bufferSize: size of the buffer, XPANDER_FORMAT_BUFFER_SIZE is enough
+@param [out] pLength: length of the formatted text, terminating zero excluded, may be NULL
+@return XPANDER_OK or XPANDER_ERROR_xxx
+*/
+LIBXPANDER_API int XPANDER_CALL XpanderFormatPatch(const XpanderPackedPatch* pPatch, char* pBuffer, size_t bufferSize, size_t* pLength);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _LIBXPANDER__